@@ -164,6 +164,8 @@ static int static_degree_dec(const void* a, const void* b) {
 	}
 }
 
+static void finish_graph_instance();
+
 static int build_simple_graph_instance(char* input_file) {
 	FILE* fp_in = fopen(input_file, "r");
 	char ch, words[WORD_LENGTH];
@@ -209,6 +211,12 @@ static int build_simple_graph_instance(char* input_file) {
 	}
 	fclose(fp_in);
 	NB_EDGE = nb_edge;
+	finish_graph_instance();
+	return TRUE;
+}
+
+static void finish_graph_instance() {
+	int i, j, nb1, nb2, node;
 	for (i = 1; i <= NB_NODE; i++) {
 		node_state[i] = ACTIVE;
 		active_degree[i] = static_degree[i];
@@ -216,7 +224,8 @@ static int build_simple_graph_instance(char* input_file) {
 		node_neibors[i] = (int*)malloc((static_degree[i] + 1) * sizeof(int));
 
 		none_degree[i] = NB_NODE - static_degree[i] - 1;
-		none_neibors[i] = (int*)malloc((NB_NODE - static_degree[i]) * sizeof(int));
+		// rebuild_matrix refills the lists of recoded vertices with up to NB_NODE - 1 entries
+		none_neibors[i] = (int*)malloc((NB_NODE + 1) * sizeof(int));
 		nb1 = 0;
 		nb2 = 0;
 		for (j = 1; j <= NB_NODE; j++) {
@@ -241,8 +250,6 @@ static int build_simple_graph_instance(char* input_file) {
 	/*printf("c Instance Information: #node=%d, #edge=%d density= %5.4f \n",*/
 	/*NB_NODE, NB_EDGE,*/
 	/*((float) NB_EDGE * 2) / (NB_NODE * (NB_NODE - 1)));*/
-
-	return TRUE;
 }
 
 static int choose_candidate_node() {
@@ -1647,8 +1654,89 @@ static void init_for_search() {
 	//	}
 }
 
-static bool search_maxclique(int cutoff, int print_info, int limit = 1000000000,
-		bool docheck = false, long sec_limit = 3600) {
+// In-process replacement of build_simple_graph_instance for the vertices 1, ..., n and the edges
+// {left[e], right[e]}, or all other pairs if complement is set. As the solver keeps its state in
+// globals, everything an earlier call left behind is reset first.
+static void build_graph_from_edges(
+		int n, const int* left, const int* right, int m, int complement) {
+	int i, j, clear = NB_NODE > n ? NB_NODE : n;
+	for (i = 1; i <= NB_NODE; i++) {
+		free(node_neibors[i]);
+		free(none_neibors[i]);
+	}
+	free(INIT_Stack);
+	free(static_matrix);
+	free(APPEND_STACK);
+	INIT_Stack = NULL;
+	static_matrix = NULL;
+	APPEND_STACK = NULL;
+	APPEND_STACK_SIZE = APPEND_STACK_USED = 0;
+	for (i = 0; i <= clear; i++) {
+		memset(matrice[i], 0, (clear + 1) * sizeof(char));
+	}
+	memset(node_state, 0, sizeof(node_state));
+	memset(node_reason, 0, sizeof(node_reason));
+	memset(iSET_Size, 0, sizeof(iSET_Size));
+	memset(iSET_State, 0, sizeof(iSET_State));
+	memset(iSET_Used, 0, sizeof(iSET_Used));
+	memset(iSET_Tested, 0, sizeof(iSET_Tested));
+	memset(iSET_Index, 0, sizeof(iSET_Index));
+	memset(static_degree, 0, sizeof(static_degree));
+	memset(active_degree, 0, sizeof(active_degree));
+	memset(none_degree, 0, sizeof(none_degree));
+	memset(Extra_Node_Index, 0, sizeof(Extra_Node_Index));
+	memset(ADDED_NODE_iSET, 0, sizeof(ADDED_NODE_iSET));
+	memset(iSET_Involved, 0, sizeof(iSET_Involved));
+	memset(tested, 0, sizeof(tested));
+	memset(Branches, 0, sizeof(Branches));
+	iSET_COUNT = 0;
+	ptr(REDUCED_iSET_STACK) = ptr(PASSIVE_iSET_STACK) = ptr(FIXED_NODE_STACK) = 0;
+	ptr(UNIT_STACK) = ptr(NEW_UNIT_STACK) = ptr(Clique_Stack) = ptr(INIT_Stack) = 0;
+	ptr(Candidate_Stack) = ptr(Cursor_Stack) = ptr(Tmp_Stack) = ptr(Extra_Node_Stack) = 0;
+	ptr(CACHED_REASON_STACK) = ptr(CONFLICT_ISET_STACK) = ptr(REASON_STACK) = 0;
+	NB_CANDIDATE = 0;
+	REBUILD_MATRIX = FALSE;
+	STATIC_ORDERING = TRUE;
+	INIT_CLIQUE = 0;
+	LIST_ALL = FALSE;
+	MAX_COUNT = SHOW_COUNT = 0;
+	MAX_CLQ_SIZE = 0;
+	Dynamic_Radio = 0.6;
+
+	NB_NODE = n;
+	NB_EDGE = 0;
+	for (i = 0; i < m; i++) {
+		if (left[i] != right[i] && matrice[left[i]][right[i]] == FALSE) {
+			matrice[left[i]][right[i]] = TRUE;
+			matrice[right[i]][left[i]] = TRUE;
+			NB_EDGE++;
+		}
+	}
+	if (complement) {
+		for (i = 1; i <= n; i++) {
+			for (j = 1; j <= n; j++) {
+				matrice[i][j] = i != j && matrice[i][j] == FALSE;
+			}
+		}
+		NB_EDGE = n * (n - 1) / 2 - NB_EDGE;
+	}
+	for (i = 1; i <= n; i++) {
+		for (j = 1; j <= n; j++) {
+			static_degree[i] += matrice[i][j];
+		}
+	}
+	finish_graph_instance();
+}
+
+static double wall_seconds() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// with docheck, the search gives up after limit branches or sec_limit seconds of wall-clock time
+static bool search_maxclique(int cutoff, int print_info, long limit = 1000000000,
+		bool docheck = false, double sec_limit = 3600) {
 	int node;
 	init_for_search();
 	BRANCHING_COUNT = 0;
@@ -1657,8 +1745,7 @@ static bool search_maxclique(int cutoff, int print_info, int limit = 1000000000,
 		printf("c  -----------------------------------------------------------------\n");
 		printf("c  Size| Index|NB_Vertex  NB_IncUB    NB_Iset  NB_MaxSat|  NB_Branch\n");
 	}
-	struct rusage starttime, endtime;
-	getrusage(RUSAGE_SELF, &starttime);
+	double deadline = wall_seconds() + sec_limit;
 	while (CURSOR > 0) {
 		node = Candidate_Stack[--CURSOR];
 		if (docheck) {
@@ -1666,19 +1753,13 @@ static bool search_maxclique(int cutoff, int print_info, int limit = 1000000000,
 				finished = false;
 				break;
 			}
-			getrusage(RUSAGE_SELF, &endtime);
-			long sec = (int)endtime.ru_utime.tv_sec;
-			if (sec > sec_limit) {
+			// the clock is only read every 1024 branches
+			if ((BRANCHING_COUNT & 1023) == 0 && wall_seconds() > deadline) {
 				finished = false;
 				break;
 			}
 		}
 
-		if (docheck && BRANCHING_COUNT > limit) {
-			finished = false;
-			break;
-		}
-
 		if (CUR_CLQ_SIZE > 0 && node > 0) {
 			continue;
 		}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ogdf/basic/basic.h>
+
+// Min-priority queue of the ids 0, ..., n - 1 with small integer keys that only decrease. Each key
+// has a doubly linked list of its ids, with the links stored in flat arrays, so that insert,
+// remove and decrease are O(1) without allocating. min() scans upwards from the smallest key that
+// may have ids, which is amortised over the inserts and decreases. Ids with the same key come out
+// in reverse insertion order.
+class BucketQueue {
+	static constexpr int NONE = -1;
+
+	std::vector<size_t> keys;
+	std::vector<int> prev, next;
+	std::vector<uint8_t> queued;
+	std::vector<int> head; // key -> first id of its list
+	size_t minkey = 0; // no list below this key has ids
+	size_t count = 0;
+
+	void link(int v) {
+		size_t k = keys[v];
+		if (k >= head.size()) {
+			head.resize(k + 1, NONE);
+		}
+		prev[v] = NONE;
+		next[v] = head[k];
+		if (head[k] != NONE) {
+			prev[head[k]] = v;
+		}
+		head[k] = v;
+		minkey = std::min(minkey, k);
+	}
+
+	void unlink(int v) {
+		if (prev[v] != NONE) {
+			next[prev[v]] = next[v];
+		} else {
+			head[keys[v]] = next[v];
+		}
+		if (next[v] != NONE) {
+			prev[next[v]] = prev[v];
+		}
+	}
+
+public:
+	explicit BucketQueue(size_t n = 0) { init(n); }
+
+	// an empty queue for the ids 0, ..., n - 1, keeping the memory
+	void init(size_t n) {
+		keys.assign(n, 0);
+		prev.resize(n);
+		next.resize(n);
+		queued.assign(n, 0);
+		head.clear();
+		minkey = 0;
+		count = 0;
+	}
+
+	bool empty() const { return count == 0; }
+
+	size_t size() const { return count; }
+
+	bool contains(int v) const { return queued[v]; }
+
+	// the key of v, also after it was removed
+	size_t key(int v) const { return keys[v]; }
+
+	void insert(int v, size_t key) {
+		OGDF_ASSERT(!queued[v]);
+		keys[v] = key;
+		queued[v] = 1;
+		++count;
+		link(v);
+	}
+
+	void remove(int v) {
+		OGDF_ASSERT(queued[v]);
+		unlink(v);
+		queued[v] = 0;
+		--count;
+	}
+
+	// decrease the key of v by one, v does not need to be in the queue
+	void decrease(int v) {
+		OGDF_ASSERT(keys[v] > 0);
+		if (!queued[v]) {
+			--keys[v];
+			return;
+		}
+		unlink(v);
+		--keys[v];
+		link(v);
+	}
+
+	// an id with the smallest key, the queue must not be empty
+	int min() {
+		OGDF_ASSERT(count > 0);
+		while (head[minkey] == NONE) {
+			++minkey;
+		}
+		return head[minkey];
+	}
+};
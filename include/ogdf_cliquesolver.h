@@ -1,98 +1,66 @@
 #pragma once
 
-#include <algorithm>
-#include <iostream>
-#include <string>
+#include <chrono>
+#include <limits>
 #include <vector>
 
 #include "ogdf_instance.hpp"
+#include "ogdf_stats.hpp"
 #include "ogdf_util.hpp"
-#include <boost/asio/io_service.hpp>
-#include <boost/process.hpp>
-#include <boost/process/async.hpp>
+#include "ogdf_vertexcover.hpp"
 
-namespace bp = boost::process;
-namespace fs = std::filesystem;
-
-std::string get_executable_directory() {
-	char result[PATH_MAX];
-	ssize_t count = readlink("/proc/self/exe", result, PATH_MAX);
-	if (count == -1) {
-		throw std::runtime_error("Failed to read /proc/self/exe");
-	}
-	fs::path exe_path(std::string(result, count));
-	return exe_path.parent_path().string();
-}
-
-bool solveMISInstanceWithCliqueSolver(Instance& I, long limit_branches, bool docheck = false,
-		long limit_seconds = 3600) {
+// Solve an instance in which every vertex to dominate can be dominated by exactly two vertices as
+// vertex cover of the conflict graph between these pairs, whose construction time is reported as
+// rule conflict_graph with PACE_STATS. Returns false if the search ran out of time or, if docheck
+// is set, branches, leaving the instance unchanged.
+inline bool solveMISInstanceWithCliqueSolver(Instance& I, long limit_branches, bool docheck = false,
+		long limit_seconds = 3600, int depth = 0) {
 	OGDF_ASSERT(I.isVCInstance());
 
-	int numvertices = 1;
-	ogdf::NodeArray<int> nodeToIndex(I.G);
+	ogdf::NodeArray<int> nodeToIndex(I.G, -1);
 	std::vector<ogdf::node> indexToNode;
-	indexToNode.push_back(nullptr);
 	for (auto node : I.G.nodes) {
 		if (!I.is_subsumed[node]) {
-			nodeToIndex[node] = numvertices;
+			nodeToIndex[node] = indexToNode.size();
 			indexToNode.push_back(node);
-			numvertices++;
 		}
 	}
-	int numedges;
-	for (int i = 1; i < numvertices; i++) {
+	// the other vertex that can dominate each vertex dominated by i
+	auto start = std::chrono::steady_clock::now();
+	ConflictGraph conflicts;
+	buildConflictGraph(indexToNode.size(), [&](uint32_t i, std::vector<uint32_t>& out) {
 		I.forAllCanDominate(indexToNode[i], [&](ogdf::node adj) {
 			I.forAllCanBeDominatedBy(adj, [&](ogdf::node adj2) {
-				if (adj2 != indexToNode[i]) {
-					numedges++;
+				if (nodeToIndex[adj2] >= 0) {
+					out.push_back(nodeToIndex[adj2]);
 				}
 				return true;
 			});
 			return true;
 		});
+	}, conflicts);
+	if (reductionStatsEnabled()) {
+		RuleCounters c;
+		c.calls = c.applied = 1;
+		c.nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start)
+						  .count();
+		recordReductionStats("conflict_graph", depth, c);
 	}
 
-	std::stringstream ofs;
-	ofs << "p td " << (numvertices - 1) << " " << numedges << std::endl;
-	for (int i = 1; i < numvertices; i++) {
-		I.forAllCanDominate(indexToNode[i], [&](ogdf::node adj) {
-			I.forAllCanBeDominatedBy(adj, [&](ogdf::node adj2) {
-				if (adj2 != indexToNode[i]) {
-					ofs << i << " " << nodeToIndex[adj2] << std::endl;
-				}
-				return true;
-			});
-			return true;
-		});
-	}
-	std::string inp = ofs.str(); // needs to be stored on stack for wrapping in buffer
-
-	log << "Trying to solve VC instance with " << numvertices - 1 << " vertices and " << numedges
-		<< " edges for " << limit_seconds << "s" << std::endl;
-	// log << std::endl << inp << std::endl;
-	boost::asio::io_service ios;
-	std::future<std::string> data;
-	bp::child c("/usr/bin/timeout " + std::to_string(limit_seconds) + " "
-					+ get_executable_directory() + "/ext/peaty/solve_vc -q",
-			bp::std_out > data, bp::std_err > stderr, bp::std_in < boost::asio::buffer(inp),
-			ios);
-	ios.run();
-	c.wait();
-	if (c.exit_code() != 0) {
-		log << "VC solver returned error " << c.exit_code() << std::endl;
+	VertexCoverLimits limits;
+	limits.branches = docheck ? limit_branches : std::numeric_limits<long>::max();
+	limits.seconds = limit_seconds;
+	log << "Trying to solve VC instance with " << indexToNode.size() << " vertices and "
+		<< conflicts.numberOfEdges() << " edges for " << limits.seconds << "s" << std::endl;
+	std::vector<int> cover;
+	if (!solveVertexCover(conflicts, limits, cover)) {
+		log << "VC solver hit its limits" << std::endl;
 		return false;
 	}
-
-	std::istringstream is(data.get());
-	std::string line;
-	int size = 0;
-	while (is && std::getline(is, line)) {
-		if (line.empty() || line[0] == 'c' || line[0] == 's') {
-			continue;
-		}
-		I.DS.insert(I.node2ID[indexToNode[std::stoi(line)]]);
-		size++;
+	for (int v : cover) {
+		I.DS.insert(I.node2ID[indexToNode[v]]);
 	}
-	log << "VC solver found solution of size " << size << std::endl;
+	log << "VC solver found solution of size " << cover.size() << std::endl;
 	return true;
 }
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ogdf_reader.hpp"
+
+// Read-only view of an array that is either owned by the InstanceCSR or lives in a mapped file.
+template<typename T>
+struct ArrayView {
+	const T* data = nullptr;
+	size_t size = 0;
+
+	ArrayView() = default;
+
+	ArrayView(const T* data, size_t size) : data(data), size(size) { }
+
+	ArrayView(const std::vector<T>& vec) : data(vec.data()), size(vec.size()) { }
+
+	const T& operator[](size_t i) const { return data[i]; }
+
+	const T* begin() const { return data; }
+
+	const T* end() const { return data + size; }
+};
+
+// The arcs of an input instance in compressed sparse row form. For ds instances, every input edge
+// {u,v} is stored once as arc u->v in the direction it was given, for hs instances, every vertex u
+// of the i-th hyperedge yields an arc u->(n+i). Node IDs are 1-based as in the input, node ID x is
+// stored at index x-1 of the offset arrays. Adjacencies are sorted ascending.
+struct InstanceCSR {
+	std::string type;
+	uint32_t n = 0;
+	uint32_t m = 0;
+	uint32_t numNodes = 0; // n for ds, n+m for hs
+
+	ArrayView<uint64_t> outOffsets; // numNodes + 1 entries
+	ArrayView<uint32_t> outTargets;
+	ArrayView<uint64_t> inOffsets; // numNodes + 1 entries
+	ArrayView<uint32_t> inSources;
+
+	std::vector<uint64_t> outOffsetsStore, inOffsetsStore;
+	std::vector<uint32_t> outTargetsStore, inSourcesStore;
+	InputBuffer mapping; // backing memory if the arrays are not owned
+
+	InstanceCSR() = default;
+	InstanceCSR(const InstanceCSR&) = delete;
+	InstanceCSR& operator=(const InstanceCSR&) = delete;
+
+	uint64_t numArcs() const { return outTargets.size; }
+
+	uint64_t outdeg(uint32_t id) const { return outOffsets[id] - outOffsets[id - 1]; }
+
+	uint64_t indeg(uint32_t id) const { return inOffsets[id] - inOffsets[id - 1]; }
+
+	ArrayView<uint32_t> out(uint32_t id) const {
+		return {outTargets.data + outOffsets[id - 1], outdeg(id)};
+	}
+
+	ArrayView<uint32_t> in(uint32_t id) const {
+		return {inSources.data + inOffsets[id - 1], indeg(id)};
+	}
+
+	// point the views at the owned storage
+	void useStore() {
+		outOffsets = outOffsetsStore;
+		outTargets = outTargetsStore;
+		inOffsets = inOffsetsStore;
+		inSources = inSourcesStore;
+	}
+};
+
+// Binary instance format: a 64 byte header followed by the four CSR arrays in the order outOffsets,
+// inOffsets (uint64_t each), outTargets, inSources (uint32_t each) in native byte order, so that a
+// memory-mapped file can directly back an InstanceCSR.
+struct BinaryInstanceHeader {
+	static constexpr char MAGIC[8] = {'P', 'A', 'C', 'E', 'B', 'I', 'N', '\0'};
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t TYPE_DS = 0;
+	static constexpr uint32_t TYPE_HS = 1;
+
+	char magic[8];
+	uint32_t version;
+	uint32_t type;
+	uint32_t n;
+	uint32_t m;
+	uint32_t numNodes;
+	uint32_t reserved;
+	uint64_t numArcs;
+	uint64_t payloadChecksum; // FNV1a over the payload, only checked on request
+	uint64_t reserved2;
+	uint64_t headerChecksum; // FNV1a over all previous fields
+
+	uint64_t computeHeaderChecksum() const;
+
+	uint64_t payloadSize() const {
+		return 2 * ((uint64_t)numNodes + 1) * sizeof(uint64_t) + 2 * numArcs * sizeof(uint32_t);
+	}
+};
+
+static_assert(sizeof(BinaryInstanceHeader) == 64);
+
+bool isBinaryInstance(const InputBuffer& buf);
+
+// Point the views of `csr` into `buf`, which needs to outlive `csr`. The header, the offsets and
+// the node IDs are always validated, pass verifyPayload to also check the payload checksum.
+void loadInstanceBinary(const InputBuffer& buf, InstanceCSR& csr, bool verifyPayload = false);
+
+// Same as above, but `csr` takes ownership of the (memory-mapped) buffer.
+void loadInstanceBinary(InputBuffer&& buf, InstanceCSR& csr, bool verifyPayload = false);
+
+bool writeInstanceBinary(const InstanceCSR& csr, std::ostream& os);
+
+bool writeInstanceText(const InstanceCSR& csr, std::ostream& os);
+
+// Parse a textual .gr / .hs instance using up to `threads` threads. The buffer is split at line
+// boundaries, the first pass counts degrees, the second one fills the adjacency arrays.
+void parseInstanceCSR(const InputBuffer& buf, InstanceCSR& csr, unsigned int threads);
+
+// Load a binary instance or parse a textual one, depending on the contents of `buf`, which needs to
+// outlive `csr`. This is the single entry point for reading instances.
+void readInstanceCSR(const InputBuffer& buf, InstanceCSR& csr, unsigned int threads);
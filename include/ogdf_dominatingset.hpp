@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+// Set of vertex IDs forming a (partial) dominating set. Small sets are kept as a vector in
+// insertion order with a flat open addressing hash set for membership, once the set holds at least
+// one ID per 64 possible IDs it switches to a bitset over [0, universe), so the memory stays linear
+// in the number of IDs while large sub-solutions are merged in O(words) without any per-element
+// allocation. Iteration is in ascending order in both representations, the vector is sorted (and
+// cleaned from erased IDs) lazily when iterating, so begin() must not race with other accesses.
+class DominatingSet {
+	static constexpr int EMPTY = -1;
+	static constexpr int ERASED = -2;
+
+	mutable std::vector<int> sparse_;
+	mutable bool sorted_ = true; // sparse_ is ascending and holds no erased IDs
+	std::vector<int> table_; // EMPTY, ERASED or an ID, with linear probing over a power of two
+	size_t used_ = 0; // slots of table_ that are not EMPTY
+	std::vector<uint64_t> words_;
+	size_t count_ = 0;
+	size_t universe_ = 0;
+	bool dense_ = false;
+
+	size_t slot(int id) const {
+		size_t mask = table_.size() - 1;
+		size_t i = ((uint32_t)id * 2654435761u) & mask;
+		while (table_[i] != EMPTY && table_[i] != id) {
+			i = (i + 1) & mask;
+		}
+		return i;
+	}
+
+	void rehash(size_t capacity) {
+		std::vector<int> old;
+		old.swap(table_);
+		table_.assign(capacity, EMPTY);
+		for (int id : old) {
+			if (id >= 0) {
+				table_[slot(id)] = id;
+			}
+		}
+		used_ = count_;
+	}
+
+	void normalize() const {
+		if (sorted_) {
+			return;
+		}
+		std::sort(sparse_.begin(), sparse_.end());
+		sparse_.erase(std::unique(sparse_.begin(), sparse_.end()), sparse_.end());
+		sparse_.erase(std::remove_if(sparse_.begin(), sparse_.end(),
+							  [&](int id) { return table_[slot(id)] != id; }),
+				sparse_.end());
+		sorted_ = true;
+	}
+
+	void makeDense() {
+		for (int id : table_) {
+			if (id >= 0) {
+				universe_ = std::max(universe_, (size_t)id + 1);
+			}
+		}
+		words_.assign((universe_ + 63) / 64, 0);
+		for (int id : table_) {
+			if (id >= 0) {
+				words_[id / 64] |= 1ull << (id % 64);
+			}
+		}
+		sparse_ = {};
+		sorted_ = true;
+		table_ = {};
+		used_ = 0;
+		dense_ = true;
+	}
+
+	void growDense(size_t id) {
+		if (id / 64 >= words_.size()) {
+			words_.resize(std::max(words_.size() * 2, id / 64 + 1), 0);
+			universe_ = words_.size() * 64;
+		}
+	}
+
+public:
+	class const_iterator {
+		const DominatingSet* set;
+		size_t pos; // index into sparse_ or bit position
+
+		void skipToSetBit() {
+			const auto& w = set->words_;
+			size_t i = pos / 64;
+			if (i >= w.size()) {
+				pos = w.size() * 64;
+				return;
+			}
+			uint64_t bits = w[i] & (~0ull << (pos % 64));
+			while (bits == 0) {
+				if (++i == w.size()) {
+					pos = w.size() * 64;
+					return;
+				}
+				bits = w[i];
+			}
+			pos = i * 64 + __builtin_ctzll(bits);
+		}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = int;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const int*;
+		using reference = int;
+
+		const_iterator(const DominatingSet* set, size_t pos) : set(set), pos(pos) {
+			if (set->dense_) {
+				skipToSetBit();
+			}
+		}
+
+		int operator*() const { return set->dense_ ? (int)pos : set->sparse_[pos]; }
+
+		const_iterator& operator++() {
+			++pos;
+			if (set->dense_) {
+				skipToSetBit();
+			}
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			auto ret = *this;
+			++*this;
+			return ret;
+		}
+
+		bool operator==(const const_iterator& o) const { return pos == o.pos; }
+
+		bool operator!=(const const_iterator& o) const { return pos != o.pos; }
+	};
+
+	// hint for the largest ID that will be inserted, usually Instance::maxid
+	void reserve(size_t maxid) {
+		if (dense_) {
+			growDense(maxid);
+		} else {
+			universe_ = std::max(universe_, maxid + 1);
+		}
+	}
+
+	size_t size() const { return count_; }
+
+	bool empty() const { return size() == 0; }
+
+	bool contains(int id) const {
+		if (dense_) {
+			return (size_t)id / 64 < words_.size() && (words_[id / 64] >> (id % 64)) & 1;
+		}
+		return !table_.empty() && table_[slot(id)] == id;
+	}
+
+	bool insert(int id) {
+		if (dense_) {
+			growDense(id);
+			uint64_t& w = words_[id / 64];
+			uint64_t bit = 1ull << (id % 64);
+			if (w & bit) {
+				return false;
+			}
+			w |= bit;
+			++count_;
+			return true;
+		}
+		if ((used_ + 1) * 2 > table_.size()) {
+			size_t capacity = 16;
+			while (capacity < (count_ + 1) * 4) {
+				capacity *= 2;
+			}
+			rehash(capacity);
+		}
+		size_t i = slot(id);
+		if (table_[i] == id) {
+			return false;
+		}
+		table_[i] = id;
+		++used_;
+		++count_;
+		if (sorted_ && !sparse_.empty() && sparse_.back() > id) {
+			sorted_ = false;
+		}
+		sparse_.push_back(id);
+		if (count_ * 64 >= std::max(universe_, (size_t)id + 1)) {
+			makeDense();
+		}
+		return true;
+	}
+
+	template<typename IT>
+	void insert(IT begin, IT end) {
+		for (; begin != end; ++begin) {
+			insert(*begin);
+		}
+	}
+
+	bool erase(int id) {
+		if (!contains(id)) {
+			return false;
+		}
+		--count_;
+		if (dense_) {
+			words_[id / 64] &= ~(1ull << (id % 64));
+			return true;
+		}
+		// the ID stays in sparse_ until the next normalize()
+		table_[slot(id)] = ERASED;
+		sorted_ = false;
+		return true;
+	}
+
+	void merge(const DominatingSet& other) {
+		if (!other.dense_) {
+			universe_ = std::max(universe_, other.universe_);
+			insert(other.begin(), other.end());
+			return;
+		}
+		if (other.words_.empty()) {
+			return;
+		}
+		if (!dense_) {
+			universe_ = std::max(universe_, other.words_.size() * 64);
+			makeDense();
+		}
+		growDense(other.words_.size() * 64 - 1);
+		for (size_t i = 0; i < other.words_.size(); ++i) {
+			count_ += __builtin_popcountll(other.words_[i] & ~words_[i]);
+			words_[i] |= other.words_[i];
+		}
+	}
+
+	void clear() {
+		sparse_.clear();
+		sorted_ = true;
+		table_.clear();
+		used_ = 0;
+		words_.clear();
+		count_ = 0;
+		universe_ = 0;
+		dense_ = false;
+	}
+
+	const_iterator begin() const {
+		normalize();
+		return const_iterator(this, 0);
+	}
+
+	const_iterator end() const {
+		normalize();
+		return const_iterator(this, dense_ ? words_.size() * 64 : sparse_.size());
+	}
+};
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ogdf/basic/basic.h>
+
+#include "ogdf_signature.hpp"
+
+// DP table of a single bag of the tree decomposition, mapping signatures (one base-3 digit per bag
+// vertex) to the minimum number of DS vertices and the signature of the child bag it came from.
+// Well-filled tables of small bags are stored densely over all 3^k signatures, so that lookups and
+// scans are plain array accesses, the others in a hash map.
+// Once the parent bag is computed, freeze() drops what the backtracking does not need and turns
+// hash maps into sorted arrays.
+class DPTable {
+public:
+	using Sig = TW_SIGNATURE_TYPE;
+	using Value = uint32_t;
+
+	static constexpr Value NONE = std::numeric_limits<Value>::max();
+	// 3^15 child signatures still fit into the 32 bit backpointers of dense tables
+	static constexpr size_t DENSE_MAX_BAG = 14;
+	// a hash map entry costs about six times as much as a dense slot
+	static constexpr size_t SPARSE_ENTRY_COST = 6;
+
+private:
+	size_t bagsize = 0;
+	size_t slots = 0;
+	size_t count = 0;
+	bool dense = false;
+	bool frozen = false;
+	// whether freeze() kept the values / backpointers
+	bool has_values = true;
+	bool has_backs = true;
+	std::vector<Value> dense_val;
+	std::vector<uint32_t> dense_back;
+	std::unordered_map<Sig, std::pair<Value, Sig>> sparse;
+	// frozen sparse tables, sorted by signature
+	std::vector<Sig> frozen_sig;
+	std::vector<Value> frozen_val;
+	std::vector<Sig> frozen_back;
+
+	static size_t pow3(size_t k) {
+		size_t p = 1;
+		while (k-- > 0) {
+			p *= 3;
+		}
+		return p;
+	}
+
+	static bool preferDense(size_t bagsize, size_t slots, size_t entries) {
+		return bagsize <= DENSE_MAX_BAG && entries * SPARSE_ENTRY_COST >= slots;
+	}
+
+	bool preferDense(size_t entries) const { return preferDense(bagsize, slots, entries); }
+
+	void makeDense() {
+		dense_val.assign(slots, NONE);
+		dense_back.assign(slots, 0);
+		for (auto& [sig, e] : sparse) {
+			dense_val[sig] = e.first;
+			dense_back[sig] = e.second;
+		}
+		sparse = {};
+		dense = true;
+	}
+
+	void makeSparse() {
+		sparse.reserve(count);
+		for (size_t sig = 0; sig < slots; ++sig) {
+			if (dense_val[sig] != NONE) {
+				sparse.emplace(sig, std::make_pair(dense_val[sig], (Sig)dense_back[sig]));
+			}
+		}
+		dense_val = {};
+		dense_back = {};
+		dense = false;
+	}
+
+public:
+	// start an empty table for a bag with `size` vertices, expecting about `expected` entries
+	void init(size_t size, size_t expected) {
+		bagsize = size;
+		slots = pow3(size);
+		count = 0;
+		dense = false;
+		frozen = false;
+		has_values = true;
+		has_backs = true;
+		dense_val = {};
+		dense_back = {};
+		sparse = {};
+		frozen_sig = {};
+		frozen_val = {};
+		frozen_back = {};
+		if (preferDense(expected)) {
+			dense_val.assign(slots, NONE);
+			dense_back.assign(slots, 0);
+			dense = true;
+		} else {
+			sparse.reserve(expected);
+		}
+	}
+
+	// bytes that init(size, expected) allocates right away, counted like memoryUsage()
+	static size_t initBytes(size_t size, size_t expected) {
+		size_t slots = pow3(size);
+		if (preferDense(size, slots, expected)) {
+			return slots * (sizeof(Value) + sizeof(uint32_t));
+		}
+		return expected * SPARSE_ENTRY_COST * (sizeof(Value) + sizeof(uint32_t));
+	}
+
+	bool isDense() const { return dense; }
+
+	size_t size() const { return count; }
+
+	// bytes held by the table, hash map entries are estimated
+	size_t memoryUsage() const {
+		if (dense) {
+			return dense_val.capacity() * sizeof(Value) + dense_back.capacity() * sizeof(uint32_t);
+		}
+		if (frozen) {
+			return frozen_sig.capacity() * sizeof(Sig) + frozen_val.capacity() * sizeof(Value)
+					+ frozen_back.capacity() * sizeof(Sig);
+		}
+		return count * SPARSE_ENTRY_COST * (sizeof(Value) + sizeof(uint32_t));
+	}
+
+	// store val for sig unless there already is a smaller or equal value
+	void update(Sig sig, size_t val, Sig back) {
+		OGDF_ASSERT(!frozen);
+		if (dense) {
+			Value& v = dense_val[sig];
+			if (v == NONE) {
+				++count;
+			} else if (v <= val) {
+				return;
+			}
+			v = (Value)val;
+			dense_back[sig] = (uint32_t)back;
+			return;
+		}
+		auto [it, inserted] = sparse.try_emplace(sig, (Value)val, back);
+		if (inserted) {
+			++count;
+		} else if (it->second.first > val) {
+			it->second = {(Value)val, back};
+		}
+	}
+
+	// Set the entry of a signature without one in a dense table. Threads may fill disjoint
+	// signatures concurrently and add the number of new entries with addFilled() afterwards.
+	void fill(Sig sig, size_t val, Sig back) {
+		OGDF_ASSERT(dense && !frozen && dense_val[sig] == NONE);
+		dense_val[sig] = (Value)val;
+		dense_back[sig] = (uint32_t)back;
+	}
+
+	void addFilled(size_t entries) { count += entries; }
+
+	bool contains(Sig sig) const { return value(sig) != NONE; }
+
+	// NONE if there is no entry for sig, throws if freeze() dropped the values
+	Value value(Sig sig) const {
+		if (!has_values) {
+			throw std::runtime_error("DPTable::value() after the values were dropped");
+		}
+		if (dense) {
+			return sig < slots ? dense_val[sig] : NONE;
+		}
+		if (frozen) {
+			auto it = std::lower_bound(frozen_sig.begin(), frozen_sig.end(), sig);
+			return it == frozen_sig.end() || *it != sig ? NONE
+														: frozen_val[it - frozen_sig.begin()];
+		}
+		auto it = sparse.find(sig);
+		return it == sparse.end() ? NONE : it->second.first;
+	}
+
+	// throws if freeze() dropped the backpointers or there is no entry for sig
+	Sig back(Sig sig) const {
+		if (!has_backs) {
+			throw std::runtime_error("DPTable::back() after the backpointers were dropped");
+		}
+		if (dense) {
+			if (sig >= slots) {
+				throw std::out_of_range("DPTable::back() of a signature outside the bag");
+			}
+			return dense_back[sig];
+		}
+		if (frozen) {
+			auto it = std::lower_bound(frozen_sig.begin(), frozen_sig.end(), sig);
+			if (it == frozen_sig.end() || *it != sig) {
+				throw std::out_of_range("DPTable::back() of a signature without entry");
+			}
+			return frozen_back[it - frozen_sig.begin()];
+		}
+		return sparse.at(sig).second;
+	}
+
+	// f(sig, value, back) for all entries
+	template<typename F>
+	void forEach(F&& f) const {
+		OGDF_ASSERT(!frozen);
+		if (dense) {
+			for (size_t sig = 0; sig < slots; ++sig) {
+				if (dense_val[sig] != NONE) {
+					f((Sig)sig, dense_val[sig], (Sig)dense_back[sig]);
+				}
+			}
+		} else {
+			for (auto& [sig, e] : sparse) {
+				f(sig, e.first, e.second);
+			}
+		}
+	}
+
+	// switch to the cheaper representation for the actual number of entries
+	void compact() {
+		OGDF_ASSERT(!frozen);
+		bool want = preferDense(count);
+		if (dense && !want) {
+			makeSparse();
+		} else if (!dense && want) {
+			makeDense();
+		}
+	}
+
+	// Keep only the values (for value() and contains()) and / or the backpointers (for back()),
+	// the accessors of dropped data throw. The table cannot be updated or scanned afterwards.
+	void freeze(bool keepValues, bool keepBacks) {
+		if (frozen) {
+			return;
+		}
+		frozen = true;
+		has_values = keepValues;
+		has_backs = keepBacks;
+		if (dense) {
+			if (!keepValues) {
+				dense_val = {};
+			}
+			if (!keepBacks) {
+				dense_back = {};
+			}
+			return;
+		}
+		frozen_sig.reserve(count);
+		for (auto& entry : sparse) {
+			frozen_sig.push_back(entry.first);
+		}
+		std::sort(frozen_sig.begin(), frozen_sig.end());
+		if (keepValues) {
+			frozen_val.reserve(count);
+		}
+		if (keepBacks) {
+			frozen_back.reserve(count);
+		}
+		for (Sig sig : frozen_sig) {
+			auto& e = sparse.find(sig)->second;
+			if (keepValues) {
+				frozen_val.push_back(e.first);
+			}
+			if (keepBacks) {
+				frozen_back.push_back(e.second);
+			}
+		}
+		sparse = {};
+	}
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tree decompositions from greedy elimination orderings of an undirected graph on the vertices
+// 0, ..., n - 1, as a quick alternative to htd when the width is small enough for the DP. The
+// degeneracy rejects graphs of large treewidth right away, and the elimination gives up as soon as
+// a bag would get larger than the limit. The result is a nice tree decomposition in flat arrays.
+class EliminationDecomposition {
+public:
+	enum class Heuristic { MIN_DEGREE, MIN_FILL };
+
+	enum class Type : uint8_t { LEAF, INTRODUCE, FORGET, JOIN };
+
+	static constexpr int NONE = -1;
+
+	// the children of a bag have smaller indices than the bag itself
+	struct Bag {
+		Type type;
+		int parent = NONE;
+		int children[2] = {NONE, NONE};
+		int vertex = NONE; // the vertex of a leaf, the introduced or the forgotten vertex
+	};
+
+	std::vector<Bag> bags;
+	// the vertices of bag b in ascending order are vertices[begin[b]], ..., vertices[begin[b+1]-1]
+	std::vector<uint32_t> begin;
+	std::vector<int> vertices;
+	int root = NONE;
+	size_t width = 0; // size of the largest bag
+
+private:
+	std::vector<std::vector<int>> adj;
+
+	// greedy elimination ordering, the bag of every vertex is the vertex and its neighbours at
+	// elimination time, returns false once a bag would get larger than maxBag
+	bool eliminate(Heuristic h, size_t maxBag, std::vector<int>& order,
+			std::vector<std::vector<int>>& elimBags) const;
+
+	// nice tree decomposition from the bags of an elimination ordering
+	void build(const std::vector<int>& order, const std::vector<std::vector<int>>& elimBags);
+
+	int addBag(Type type, int vertex, const std::vector<int>& content, int child1, int child2);
+
+public:
+	// the neighbourhoods must be symmetric, but may contain duplicates and loops
+	explicit EliminationDecomposition(std::vector<std::vector<int>> neighbours);
+
+	size_t numberOfVertices() const { return adj.size(); }
+
+	// the degeneracy, a lower bound for the treewidth
+	size_t lowerBound() const;
+
+	// Compute a decomposition with bags of at most maxBag vertices, false if the heuristic does not
+	// find one. An earlier result is replaced only on success.
+	bool compute(Heuristic h, size_t maxBag);
+
+	size_t bagSize(int b) const { return begin[b + 1] - begin[b]; }
+
+	const int* bagBegin(int b) const { return vertices.data() + begin[b]; }
+
+	const int* bagEnd(int b) const { return vertices.data() + begin[b + 1]; }
+};
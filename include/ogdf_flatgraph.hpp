@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ogdf_csr.hpp"
+
+// Contiguous replacement for the ogdf::Graph inside Instance, used for the cheap reductions on the
+// full input. The out- and in-arcs of every node live in per-node segments of two flat arrays and
+// every arc entry stores the position of its twin in the other array, so deleting or hiding an arc
+// is O(1) and only leaves a tombstone. A segment that runs out of space is moved to the end of its
+// array; compact() drops all tombstones and abandoned segments. Live arcs u->v and v->u that stem
+// from the same undirected edge are paired up as reverses of each other, which is recorded when
+// they are created, so that parallel arcs stay distinguishable.
+class FlatGraph {
+public:
+	using node = uint32_t;
+	using arc = uint64_t; // position of the arc in the out array, only stable until compact()
+	static constexpr arc NO_ARC = static_cast<arc>(-1);
+
+	enum ArcState : uint32_t { ARC_LIVE = 0, ARC_HIDDEN = 1, ARC_DELETED = 2 };
+
+	struct Entry {
+		node other; // target for out entries, source for in entries
+		uint32_t state;
+		uint64_t twin; // position of the corresponding entry in the other array
+	};
+
+private:
+	struct Segment {
+		uint64_t begin = 0;
+		uint32_t size = 0; // used slots, including tombstones
+		uint32_t cap = 0;
+		uint32_t live = 0;
+		uint32_t hidden = 0;
+	};
+
+	std::vector<Entry> out_, in_;
+	std::vector<arc> reverse_; // parallel to out_
+	std::vector<Segment> outSeg_, inSeg_;
+	std::vector<uint8_t> deleted_;
+	uint64_t deadSlots_ = 0;
+	uint64_t liveArcs_ = 0;
+	uint32_t liveNodes_ = 0;
+
+	void append(std::vector<Entry>& arr, std::vector<Entry>& other, Segment& seg, Entry e);
+
+	void release(uint64_t a, bool hidden);
+
+	void unpair(arc a) {
+		if (reverse_[a] != NO_ARC) {
+			reverse_[reverse_[a]] = NO_ARC;
+			reverse_[a] = NO_ARC;
+		}
+	}
+
+public:
+	void init(const InstanceCSR& csr, bool symmetric);
+
+	node addNode();
+
+	arc addArc(node u, node v);
+
+	void deleteArc(arc a);
+
+	void hideArc(arc a);
+
+	void restoreArc(arc a);
+
+	// record that the live arcs a = u->v and b = v->u are reverses of each other
+	void pairArcs(arc a, arc b);
+
+	void deleteNode(node v);
+
+	// drop tombstones if they make up more than the given fraction of all slots
+	bool compact(double maxDeadFraction = 0.5);
+
+	node source(arc a) const { return in_[out_[a].twin].other; }
+
+	node target(arc a) const { return out_[a].other; }
+
+	bool isHidden(arc a) const { return out_[a].state == ARC_HIDDEN; }
+
+	// the live arc paired with a, or NO_ARC. Deleting or hiding one of them unpairs both.
+	arc reverse(arc a) const { return reverse_[a]; }
+
+	uint32_t outdeg(node v) const { return outSeg_[v].live; }
+
+	uint32_t indeg(node v) const { return inSeg_[v].live; }
+
+	bool isDeleted(node v) const { return deleted_[v]; }
+
+	uint32_t numberOfNodes() const { return liveNodes_; }
+
+	uint64_t numberOfEdges() const { return liveArcs_; }
+
+	// node slots, including deleted ones
+	uint32_t nodeSlots() const { return deleted_.size(); }
+
+	// upper bound for arc positions
+	uint64_t arcSlots() const { return out_.size(); }
+
+	uint64_t memoryUsage() const {
+		return (out_.capacity() + in_.capacity()) * sizeof(Entry)
+				+ reverse_.capacity() * sizeof(arc)
+				+ (outSeg_.capacity() + inSeg_.capacity()) * sizeof(Segment) + deleted_.capacity();
+	}
+
+	// f(arc, target) for all live out-arcs of v, stops as soon as f returns false.
+	// Arcs may be deleted or hidden from within f, but not added.
+	template<typename F>
+	bool forAllOut(node v, F&& f) const {
+		const auto& seg = outSeg_[v];
+		for (uint64_t a = seg.begin, e = seg.begin + seg.size; a < e; ++a) {
+			if (out_[a].state == ARC_LIVE && !f(a, out_[a].other)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// f(arc, source) for all live in-arcs of v, where arc is the position in the out array
+	template<typename F>
+	bool forAllIn(node v, F&& f) const {
+		const auto& seg = inSeg_[v];
+		for (uint64_t i = seg.begin, e = seg.begin + seg.size; i < e; ++i) {
+			if (in_[i].state == ARC_LIVE && !f(in_[i].twin, in_[i].other)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// f(arc, isSource) for all hidden arcs incident to v
+	template<typename F>
+	void forAllHidden(node v, F&& f) const {
+		const auto& os = outSeg_[v];
+		for (uint64_t a = os.begin, e = os.begin + os.size; a < e && os.hidden > 0; ++a) {
+			if (out_[a].state == ARC_HIDDEN) {
+				f(a, true);
+			}
+		}
+		const auto& is = inSeg_[v];
+		for (uint64_t i = is.begin, e = is.begin + is.size; i < e && is.hidden > 0; ++i) {
+			if (in_[i].state == ARC_HIDDEN) {
+				f(in_[i].twin, false);
+			}
+		}
+	}
+};
+
+// The state of an Instance on top of a FlatGraph, with the same node flags and the
+// add/delete/hide operations that the reduction rules need. Input node v has the ID v + 1.
+struct FlatInstance {
+	using node = FlatGraph::node;
+
+	FlatGraph G;
+	std::vector<int> node2ID;
+	std::vector<uint8_t> is_dominated;
+	std::vector<uint8_t> is_subsumed;
+	std::vector<uint8_t> is_hidden_loop;
+	std::vector<int> DS;
+	size_t maxid = 0;
+	std::string type;
+
+	void read(const InputBuffer& buf);
+
+	void initFromCSR(const InstanceCSR& csr);
+
+	node addNode();
+
+	void addToDominatingSet(node v);
+
+	void markDominated(node v, bool byreduction = false);
+
+	void markSubsumed(node v);
+
+	void safeDelete(node v) { G.deleteNode(v); }
+
+	void removeHiddenIncomingEdges(node v);
+
+	void removeHiddenOutgoingEdges(node v);
+
+	bool reductionExtremeDegrees();
+
+	bool reductionContraction();
+
+	// run the cheap reductions until nothing changes anymore
+	void reduce();
+};
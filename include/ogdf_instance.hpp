@@ -1,7 +1,12 @@
 #pragma once
 
+#include <unordered_map>
 #include <unordered_set>
 
+#include "ogdf_csr.hpp"
+#include "ogdf_dominatingset.hpp"
+#include "ogdf_flatgraph.hpp"
+#include "ogdf_reader.hpp"
 #include "ogdf_util.hpp"
 
 struct Instance {
@@ -12,14 +17,12 @@ private:
 			ogdf::NodeArray<bool>& inadjv, const ogdf::NodeArray<u_int64_t>& inadjMask);
 	ogdf::NodeArray<u_int64_t> computeOutadjMask();
 	ogdf::NodeArray<u_int64_t> computeInadjMask();
-	void read_DS(std::istream& is, std::vector<ogdf::node>& ID2node, unsigned int n, unsigned int m);
-	void read_HS(std::istream& is, std::vector<ogdf::node>& ID2node, unsigned int n, unsigned int m);
 
 public:
 	ogdf::Graph G;
 	// std::vector<ogdf::node> ID2node;
 	ogdf::NodeArray<int> node2ID;
-	std::unordered_set<int> DS;
+	DominatingSet DS;
 	ogdf::NodeArray<bool> is_dominated;
 	ogdf::NodeArray<bool> is_subsumed;
 	ogdf::NodeArray<bool> is_hidden_loop;
@@ -29,13 +32,26 @@ public:
 	size_t maxid;
 	std::string type;
 
+	// Worklists of the incremental reductions. The mutations below touch every vertex whose degrees
+	// or flags they change, so reductionExtremeDegrees and reductionContraction only revisit those.
+	// Until seedWorklists() was called, every vertex counts as dirty. Only these two rules are
+	// incremental, neighborhood_subsets, Special1, Special2 and the BC tree still scan the whole
+	// graph. The worklists are FIFO, so a vertex touched during a pass is rechecked after the ones
+	// already queued instead of in the order of G.nodes as by a full rescan. The rules are not
+	// confluent, so the kernel (but not its optimal DS size) may differ from the one of full scans.
+	ogdf::NodeSet dirty_degrees;
+	ogdf::NodeSet dirty_contraction;
+	bool worklists_seeded = false;
+
 	Instance()
 		: node2ID(G, -1)
 		, is_dominated(G, false)
 		, is_hidden_loop(G, false)
 		, is_subsumed(G, false)
 		, reverse_edge(G, nullptr)
-		, hidden_edges(G) { }
+		, hidden_edges(G)
+		, dirty_degrees(G)
+		, dirty_contraction(G) { }
 
 	OGDF_NO_COPY(Instance)
 	OGDF_NO_MOVE(Instance)
@@ -49,6 +65,31 @@ public:
 		is_subsumed.init(G, false);
 		is_hidden_loop.init(G, false);
 		reverse_edge.init(G, nullptr);
+		worklists_seeded = false;
+	}
+
+	void seedWorklists() {
+		if (worklists_seeded) {
+			return;
+		}
+		for (auto n : G.nodes) {
+			touch(n);
+		}
+		worklists_seeded = true;
+	}
+
+	void touch(ogdf::node v) {
+		dirty_degrees.insert(v);
+		dirty_contraction.insert(v);
+	}
+
+	// v's flags changed, so its in-neighbours may now be contracted into v
+	void touchFlags(ogdf::node v) {
+		touch(v);
+		forAllInAdj(v, [&](ogdf::adjEntry adj) {
+			dirty_contraction.insert(adj->twinNode());
+			return true;
+		});
 	}
 
 	bool checkNode(ogdf::node n) {
@@ -145,6 +186,7 @@ public:
 			}
 		}
 		this->maxid = other.maxid;
+		DS.reserve(maxid);
 	}
 
 	void read(std::istream& is) {
@@ -154,6 +196,19 @@ public:
 
 	void read(std::istream& is, std::vector<ogdf::node>& ID2node);
 
+	void read(const InputBuffer& buf) {
+		std::vector<ogdf::node> ID2node;
+		read(buf, ID2node);
+	}
+
+	void read(const InputBuffer& buf, std::vector<ogdf::node>& ID2node);
+
+	// bulk initialization from an already parsed instance
+	void initFromCSR(const InstanceCSR& csr, std::vector<ogdf::node>& ID2node);
+
+	// take over the kernel (and partial DS) left by the flat reductions
+	void initFromFlat(const FlatInstance& F);
+
 	void dumpBCTree();
 
 	void safeDelete(ogdf::node n, ogdf::Graph::node_iterator& it) {
@@ -166,6 +221,9 @@ public:
 	void safeDelete(ogdf::node n) {
 		// ID2node[node2ID[n]] = nullptr;
 		logd << "\tsafe delete " << node2ID[n] << std::endl;
+		for (auto adj : n->adjEntries) {
+			touch(adj->twinNode());
+		}
 		G.delNode(n);
 	}
 
@@ -175,6 +233,8 @@ public:
 			OGDF_ASSERT(reverse_edge[r] == e);
 			reverse_edge[r] = nullptr;
 		}
+		touch(e->source());
+		touch(e->target());
 		G.delEdge(e);
 	}
 
@@ -193,11 +253,19 @@ public:
 			l << " " << *it;
 		}
 		l << std::endl;
-		std::copy(begin, end, std::inserter(DS, DS.end()));
+		DS.insert(begin, end);
 		log << "Updated DS" << (comment.empty() ? "" : " with ") << comment << ": " << before << "+"
 			<< (DS.size() - before) << "=" << DS.size() << std::endl;
 #else
-		std::copy(begin, end, std::inserter(DS, DS.end()));
+		DS.insert(begin, end);
+#endif
+	}
+
+	void addToDominatingSet(const DominatingSet& other, std::string comment = "") {
+#ifdef OGDF_DEBUG
+		addToDominatingSet(other.begin(), other.end(), comment);
+#else
+		DS.merge(other);
 #endif
 	}
 
@@ -216,10 +284,10 @@ public:
 			}
 		});
 		{
-			auto gll = logger.globalLogLevel();
-			logger.globalLogLevel(ogdf::Logger::Level::Alarm);
+			auto lll = logger.localLogLevel();
+			logger.localLogLevel(ogdf::Logger::Level::Alarm);
 			safeDelete(v, it);
-			logger.globalLogLevel(gll);
+			logger.localLogLevel(lll);
 		}
 	}
 
@@ -230,7 +298,9 @@ public:
 			is_hidden_loop[v] = false;
 		}
 		is_dominated[v] = true;
+		touch(v);
 		forAllInAdj(v, [&](ogdf::adjEntry adj) {
+			touch(adj->twinNode());
 			ogdf::edge e = adj->theEdge();
 			ogdf::edge r = reverse_edge[e];
 			if (r != nullptr) {
@@ -253,6 +323,7 @@ public:
 	void markSubsumed(ogdf::node v) {
 		is_hidden_loop[v] = false;
 		is_subsumed[v] = true;
+		touchFlags(v);
 		forAllOutAdj(v, [&](ogdf::adjEntry adj) {
 			safeDelete(adj->theEdge());
 			return true;
@@ -304,7 +375,8 @@ public:
 		}
 	}
 
-	inline bool forAllCanDominate(ogdf::node v, std::function<bool(ogdf::node)> f) {
+	template<typename F>
+	inline bool forAllCanDominate(ogdf::node v, F&& f) {
 		bool ret = forAllOutAdj(v, [&](ogdf::adjEntry adj) { return f(adj->twinNode()); });
 		if (ret && !is_subsumed[v] && !is_dominated[v]) {
 			return f(v);
@@ -313,7 +385,8 @@ public:
 		}
 	}
 
-	inline bool forAllCanBeDominatedBy(ogdf::node v, std::function<bool(ogdf::node)> f) {
+	template<typename F>
+	inline bool forAllCanBeDominatedBy(ogdf::node v, F&& f) {
 		bool ret = forAllInAdj(v, [&](ogdf::adjEntry adj) { return f(adj->twinNode()); });
 		if (ret && !is_subsumed[v] && !is_dominated[v]) {
 			return f(v);
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Number of worker threads, can be overridden by the environment variable PACE_THREADS.
+inline unsigned int paceThreads() {
+	static const unsigned int threads = [] {
+		const char* env = std::getenv("PACE_THREADS");
+		if (env != nullptr && std::atoi(env) > 0) {
+			return (unsigned int)std::atoi(env);
+		}
+		return std::max(1u, std::thread::hardware_concurrency());
+	}();
+	return threads;
+}
+
+// Run f(0), ..., f(count - 1) on separate threads and wait for all of them.
+inline void parallelFor(unsigned int count, const std::function<void(unsigned int)>& f) {
+	if (count <= 1) {
+		if (count == 1) {
+			f(0);
+		}
+		return;
+	}
+	std::vector<std::thread> threads;
+	threads.reserve(count - 1);
+	for (unsigned int t = 1; t < count; ++t) {
+		threads.emplace_back(f, t);
+	}
+	f(0);
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+// Work-stealing pool with paceThreads() - 1 worker threads. Every worker owns a queue, threads
+// outside of the pool share queue 0. Tasks are taken from the front of the own queue first and
+// stolen from the front of the other queues, so within a batch the first task is started first.
+class TaskPool {
+public:
+	using Task = std::function<void()>;
+
+	static TaskPool& get();
+
+	unsigned int threads() const { return queues.size(); }
+
+private:
+	friend class TaskGroup;
+
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> workers;
+	std::atomic<size_t> queued {0};
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+
+	explicit TaskPool(unsigned int threads);
+
+	// put the tasks in order in front of the queue of the calling thread
+	void push(std::vector<Task>& batch);
+
+	// run one queued task, returns false if there was none
+	bool runOne();
+
+	// sleep until tasks are queued or ready() holds, ready() is rechecked after every notify()
+	template<typename P>
+	void idle(P&& ready) {
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		wake.wait(lock, [&] { return queued > 0 || ready(); });
+	}
+
+	void notify() {
+		// an idle thread is either still before its check or already waiting
+		{ std::lock_guard<std::mutex> lock(sleep_mutex); }
+		wake.notify_all();
+	}
+
+	void workerLoop(unsigned int id);
+};
+
+// A set of tasks that are submitted with run() and then started by wait(), in the order in which
+// they were added. The waiting thread works on queued tasks (its own ones first) until all tasks of
+// the group are done, so groups can be nested within tasks. The first exception thrown by a task is
+// rethrown by wait().
+class TaskGroup {
+	std::vector<TaskPool::Task> batch;
+	std::atomic<size_t> open {0};
+	std::mutex error_mutex;
+	std::exception_ptr error;
+
+public:
+	TaskGroup() = default;
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+	// tasks must not outlive the data they reference, so wait for them if wait() was skipped
+	~TaskGroup() {
+		if (!batch.empty() || open > 0) {
+			try {
+				wait();
+			} catch (...) { }
+		}
+	}
+
+	void run(std::function<void()> f);
+
+	void wait();
+};
+
+// Split [0, n) into ranges of at least grain elements, a few per thread, and run f(begin, end) for
+// all of them on the pool. Small inputs are handled by the calling thread alone.
+template<typename F>
+void parallelRanges(size_t n, size_t grain, F&& f) {
+	size_t parts = std::min<size_t>(4 * TaskPool::get().threads(), n / std::max<size_t>(grain, 1));
+	if (parts <= 1) {
+		f((size_t)0, n);
+		return;
+	}
+	TaskGroup group;
+	for (size_t p = 0; p < parts; ++p) {
+		group.run([&f, p, parts, n] { f(n * p / parts, n * (p + 1) / parts); });
+	}
+	group.wait();
+}
+
+// Cooperative cancellation of long running solver calls. Solvers poll requested() or register a
+// Hook that interrupts them from the cancelling thread, e.g. by setting a termination flag of an
+// external solver. A Hook is removed by its destructor, so it must not outlive what it interrupts.
+class Cancellation {
+	std::atomic<bool> cancelled {false};
+	std::mutex mutex;
+	std::list<std::function<void()>> hooks;
+
+public:
+	class Hook {
+		Cancellation& owner;
+		std::list<std::function<void()>>::iterator it;
+
+	public:
+		// f is called right away if the cancellation was already requested
+		Hook(Cancellation& owner, std::function<void()> f) : owner(owner) {
+			std::lock_guard<std::mutex> lock(owner.mutex);
+			it = owner.hooks.insert(owner.hooks.end(), std::move(f));
+			if (owner.cancelled) {
+				(*it)();
+			}
+		}
+
+		~Hook() {
+			std::lock_guard<std::mutex> lock(owner.mutex);
+			owner.hooks.erase(it);
+		}
+
+		Hook(const Hook&) = delete;
+		Hook& operator=(const Hook&) = delete;
+	};
+
+	Cancellation() = default;
+	Cancellation(const Cancellation&) = delete;
+	Cancellation& operator=(const Cancellation&) = delete;
+
+	bool requested() const { return cancelled.load(std::memory_order_relaxed); }
+
+	void cancel() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (cancelled.exchange(true)) {
+			return;
+		}
+		for (auto& f : hooks) {
+			f();
+		}
+	}
+};
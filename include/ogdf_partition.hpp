@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <ogdf/basic/basic.h>
+
+// Partition refinement over some of the ids 0, ..., n - 1. The ids of every bag are a contiguous
+// range of a single permutation array, and refining moves the touched ids of a bag to the front of
+// its range, where they become a new bag. So the bags are the classes of ids that were touched by
+// the same set of refiners, and the new bag of a round has a strictly larger set than the bag it
+// was split from.
+// The strict inclusions between these sets are kept as a DAG in flat arrays: every bag has the
+// bags with strictly smaller sets in a segment of one entry array, which is written once when the
+// bag is created, and the bags with strictly larger sets in a list threaded through the same
+// entries. Entries of removed bags are skipped.
+class PartitionRefinement {
+public:
+	static constexpr int NONE = -1;
+
+private:
+	static constexpr size_t NO_ENTRY = static_cast<size_t>(-1);
+
+	struct Bag {
+		size_t begin, end; // the ids are perm[begin], ..., perm[end-1]
+		int refined = NONE; // the new bag of the ids touched in the current round
+		size_t sub_begin = 0, sub_end = 0; // the entries of the bags with strictly smaller sets
+		size_t sup_head = NO_ENTRY; // the first entry of a bag with a strictly larger set
+		size_t supersets = 0; // number of those that are not removed
+		bool removed = false;
+	};
+
+	std::vector<int> perm;
+	std::vector<int> bag_of;
+	std::vector<size_t> pos;
+	std::vector<Bag> bags;
+	// entry e says that the set of sup_of[e] is strictly larger than that of sub_of[e], sup_next[e]
+	// is the next entry with the same sub_of
+	std::vector<int> sub_of, sup_of;
+	std::vector<size_t> sup_next;
+	std::vector<int> touched; // the bags touched in the current round
+	size_t first_new = 0; // the bags from here on were created in the current round
+
+	void swapPositions(size_t i, size_t j) {
+		std::swap(perm[i], perm[j]);
+		pos[perm[i]] = i;
+		pos[perm[j]] = j;
+	}
+
+	void addEntry(int sup, int sub);
+
+	void removeBag(int b);
+
+public:
+	explicit PartitionRefinement(size_t n = 0) { init(n); }
+
+	// no bags over the ids 0, ..., n - 1, keeping the memory
+	void init(size_t n);
+
+	// a new empty bag without relations, the ids are added with insert() right away
+	int addBag();
+
+	// add v to the last created bag
+	void insert(int v);
+
+	int bagOf(int v) const { return bag_of[v]; }
+
+	size_t size(int b) const { return bags[b].end - bags[b].begin; }
+
+	const int* bagBegin(int b) const { return perm.data() + bags[b].begin; }
+
+	const int* bagEnd(int b) const { return perm.data() + bags[b].end; }
+
+	int back(int b) const { return perm[bags[b].end - 1]; }
+
+	void moveToFront(int v) { swapPositions(pos[v], bags[bag_of[v]].begin); }
+
+	// remove v from its bag, a bag that gets empty is removed as well
+	void remove(int v);
+
+	// move v to the new bag of the touched ids of its bag
+	void touch(int v);
+
+	// relate the new bags of this round and remove the bags that all ids moved out of
+	void finishRound();
+
+	bool hasSuperset(int b) const { return bags[b].supersets > 0; }
+
+	bool hasSubset(int b) const;
+
+	// number of entries ever added to the DAG
+	size_t numberOfEntries() const { return sub_of.size(); }
+
+	// f(b) for all bags that are not removed
+	template<typename F>
+	void forEachBag(F&& f) const {
+		for (int b = 0; b < (int)bags.size(); ++b) {
+			if (!bags[b].removed) {
+				f(b);
+			}
+		}
+	}
+
+	// f(a) for all bags a with a strictly larger set than b, f may remove bags
+	template<typename F>
+	void forEachSuperset(int b, F&& f) {
+		size_t prev = NO_ENTRY;
+		for (size_t e = bags[b].sup_head; e != NO_ENTRY;) {
+			size_t next = sup_next[e];
+			if (bags[sup_of[e]].removed) {
+				// unlink, so that later walks do not see it again
+				(prev == NO_ENTRY ? bags[b].sup_head : sup_next[prev]) = next;
+			} else {
+				f(sup_of[e]);
+				prev = e;
+			}
+			e = next;
+		}
+	}
+};
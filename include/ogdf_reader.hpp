@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Contiguous view of a whole input file. Regular files are memory-mapped, everything else (pipes,
+// std::istream) is read in large blocks into a single heap buffer. gzip (and, if built with
+// PACE_HAVE_ZSTD, zstd) compressed input is detected by its magic bytes and inflated as a whole into
+// the heap buffer before parsing, the parsers always see the complete uncompressed file.
+class InputBuffer {
+	const char* data_ = nullptr;
+	size_t size_ = 0;
+	void* map_ = nullptr;
+	size_t mapSize_ = 0;
+	std::vector<char> heap_;
+
+	void release();
+
+	bool decompress();
+
+public:
+	static constexpr size_t BLOCK_SIZE = 1 << 20;
+
+	InputBuffer() = default;
+
+	InputBuffer(const InputBuffer&) = delete;
+	InputBuffer& operator=(const InputBuffer&) = delete;
+
+	InputBuffer(InputBuffer&& other) noexcept { *this = std::move(other); }
+
+	InputBuffer& operator=(InputBuffer&& other) noexcept;
+
+	~InputBuffer() { release(); }
+
+	bool openFile(const std::string& path);
+
+	bool readFd(int fd);
+
+	bool readStream(std::istream& is);
+
+	const char* begin() const { return data_; }
+
+	const char* end() const { return data_ + size_; }
+
+	size_t size() const { return size_; }
+
+	bool isMapped() const { return map_ != nullptr; }
+
+	static bool isCompressed(const char* data, size_t size);
+};
+
+// Allocation-free scanner for the line-based PACE formats. Lines that are empty, only contain
+// whitespace or start with 'c' are comments.
+class LineScanner {
+	const char* p;
+	const char* line;
+	const char* const e;
+
+	static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+public:
+	LineScanner(const char* begin, const char* end) : p(begin), line(begin), e(end) { }
+
+	const char* pos() const { return p; }
+
+	// Moves to the start of the next data line (staying on the current one if it is a data line).
+	// Returns false if the input ends before.
+	bool nextDataLine() {
+		while (p < e) {
+			line = p;
+			while (p < e && isBlank(*p)) {
+				++p;
+			}
+			if (p < e && *p != '\n' && !(p == line && *p == 'c')) {
+				return true;
+			}
+			skipLine();
+		}
+		return false;
+	}
+
+	void skipLine() {
+		while (p < e && *p != '\n') {
+			++p;
+		}
+		if (p < e) {
+			++p;
+		}
+	}
+
+	// Reads the next unsigned integer on the current line.
+	// Returns false at the end of the line or if the next token is not a number.
+	bool readUInt(unsigned int& v) {
+		while (p < e && isBlank(*p)) {
+			++p;
+		}
+		if (p >= e || static_cast<unsigned char>(*p - '0') > 9) {
+			return false;
+		}
+		unsigned int r = 0;
+		do {
+			r = r * 10 + static_cast<unsigned int>(*p - '0');
+			++p;
+		} while (p < e && static_cast<unsigned char>(*p - '0') <= 9);
+		v = r;
+		return true;
+	}
+
+	// Reads the next whitespace-delimited token on the current line, empty at the end of the line.
+	std::string_view readToken() {
+		while (p < e && isBlank(*p)) {
+			++p;
+		}
+		const char* start = p;
+		while (p < e && !isBlank(*p) && *p != '\n') {
+			++p;
+		}
+		return std::string_view(start, p - start);
+	}
+
+	std::string_view currentLine(size_t maxlen = 100) const {
+		const char* le = line;
+		while (le < e && *le != '\n' && (size_t)(le - line) < maxlen) {
+			++le;
+		}
+		return std::string_view(line, le - line);
+	}
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Signatures of the treewidth DP: the state of the i-th bag vertex (in sorted order) is the i-th
+// base-3 digit. All operations use precomputed powers of three and do not allocate.
+typedef size_t TW_SIGNATURE_TYPE;
+#define TW_WAITING 0
+#define TW_DOMINATED 1
+#define TW_INDS 2
+#define TW_QM 1
+
+// 3^40 is the largest power of three that fits into 64 bits
+constexpr size_t TW_MAX_SIG_LEN = 40;
+
+constexpr std::array<TW_SIGNATURE_TYPE, TW_MAX_SIG_LEN + 1> POW3 = [] {
+	std::array<TW_SIGNATURE_TYPE, TW_MAX_SIG_LEN + 1> p {};
+	p[0] = 1;
+	for (size_t i = 1; i <= TW_MAX_SIG_LEN; ++i) {
+		p[i] = p[i - 1] * 3;
+	}
+	return p;
+}();
+
+inline TW_SIGNATURE_TYPE sigAt(TW_SIGNATURE_TYPE id, size_t i) { return id / POW3[i] % 3; }
+
+inline TW_SIGNATURE_TYPE sigAtSet(TW_SIGNATURE_TYPE id, size_t i, TW_SIGNATURE_TYPE status) {
+	return id - sigAt(id, i) * POW3[i] + status * POW3[i];
+}
+
+// remove the digit at index i
+inline TW_SIGNATURE_TYPE stripSigAt(TW_SIGNATURE_TYPE id, size_t i) {
+	return id % POW3[i] + id / POW3[i + 1] * POW3[i];
+}
+
+// insert a digit at index i, moving the digits from i on one position up
+inline TW_SIGNATURE_TYPE insertSigAt(TW_SIGNATURE_TYPE id, size_t i, TW_SIGNATURE_TYPE status) {
+	return id % POW3[i] + status * POW3[i] + id / POW3[i] * POW3[i + 1];
+}
+
+namespace internal {
+// number of digits with the given status in each of the 3^8 blocks of 8 digits
+constexpr size_t SIG_BLOCK_LEN = 8;
+
+template<TW_SIGNATURE_TYPE STATUS>
+constexpr std::array<uint8_t, POW3[SIG_BLOCK_LEN]> sigBlockCounts() {
+	std::array<uint8_t, POW3[SIG_BLOCK_LEN]> counts {};
+	for (size_t b = 0; b < POW3[SIG_BLOCK_LEN]; ++b) {
+		size_t id = b;
+		for (size_t i = 0; i < SIG_BLOCK_LEN; ++i) {
+			counts[b] += id % 3 == STATUS;
+			id /= 3;
+		}
+	}
+	return counts;
+}
+
+constexpr auto SIG_BLOCK_WAITING = sigBlockCounts<TW_WAITING>();
+constexpr auto SIG_BLOCK_INDS = sigBlockCounts<TW_INDS>();
+}
+
+inline size_t cntUndominated(TW_SIGNATURE_TYPE id, size_t vecsize) {
+	size_t cnt = 0;
+	for (; vecsize >= internal::SIG_BLOCK_LEN; vecsize -= internal::SIG_BLOCK_LEN) {
+		cnt += internal::SIG_BLOCK_WAITING[id % POW3[internal::SIG_BLOCK_LEN]];
+		id /= POW3[internal::SIG_BLOCK_LEN];
+	}
+	// the missing upper digits of the last block are zero and thus counted as waiting
+	return cnt + internal::SIG_BLOCK_WAITING[id] - (internal::SIG_BLOCK_LEN - vecsize);
+}
+
+inline size_t cntInDs(TW_SIGNATURE_TYPE id) {
+	size_t cnt = 0;
+	while (id > 0) {
+		cnt += internal::SIG_BLOCK_INDS[id % POW3[internal::SIG_BLOCK_LEN]];
+		id /= POW3[internal::SIG_BLOCK_LEN];
+	}
+	return cnt;
+}
+
+// The same signature with two bits per vertex (digit i in bits 2i and 2i+1), for up to 32 vertices.
+// Checks over sets of vertices, given as masks with bit 2i set for vertex i, are single word
+// operations.
+struct PackedSig {
+	static constexpr size_t MAX_LEN = 32;
+	static constexpr uint64_t LO = 0x5555555555555555ull;
+
+	uint64_t bits = 0;
+
+	static constexpr uint64_t vertex(size_t i) { return 1ull << (2 * i); }
+
+	static constexpr uint64_t vertices(size_t len) {
+		return len >= MAX_LEN ? LO : (vertex(len) - 1) & LO;
+	}
+
+	static PackedSig fromSig(TW_SIGNATURE_TYPE id, size_t len) {
+		PackedSig p;
+		for (size_t i = 0; i < len; ++i) {
+			p.bits |= (uint64_t)(id % 3) << (2 * i);
+			id /= 3;
+		}
+		return p;
+	}
+
+	TW_SIGNATURE_TYPE toSig(size_t len) const {
+		TW_SIGNATURE_TYPE id = 0;
+		for (size_t i = len; i-- > 0;) {
+			id = id * 3 + at(i);
+		}
+		return id;
+	}
+
+	// toSig of the signature with the status inserted at index
+	TW_SIGNATURE_TYPE toSigWithInsert(size_t len, size_t index, TW_SIGNATURE_TYPE status) const {
+		TW_SIGNATURE_TYPE id = 0;
+		for (size_t i = len; i-- > index;) {
+			id = id * 3 + at(i);
+		}
+		id = id * 3 + status;
+		for (size_t i = index; i-- > 0;) {
+			id = id * 3 + at(i);
+		}
+		return id;
+	}
+
+	TW_SIGNATURE_TYPE at(size_t i) const { return (bits >> (2 * i)) & 3; }
+
+	void set(size_t i, TW_SIGNATURE_TYPE status) {
+		bits = (bits & ~(3ull << (2 * i))) | ((uint64_t)status << (2 * i));
+	}
+
+	// mask of the vertices among `of` that have the given status
+	uint64_t with(TW_SIGNATURE_TYPE status, uint64_t of) const {
+		uint64_t lo = bits & LO, hi = (bits >> 1) & LO;
+		switch (status) {
+		case TW_WAITING:
+			return ~(lo | hi) & of;
+		case TW_DOMINATED:
+			return lo & ~hi & of;
+		default:
+			return hi & ~lo & of;
+		}
+	}
+
+	size_t count(TW_SIGNATURE_TYPE status, size_t len) const {
+		return __builtin_popcountll(with(status, vertices(len)));
+	}
+
+	bool anyInDs(uint64_t of) const { return with(TW_INDS, of) != 0; }
+
+	// mark the waiting vertices among `of` as dominated
+	void dominate(uint64_t of) { bits |= with(TW_WAITING, of); }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ogdf_instance.hpp"
+#include "ogdf_parallel.hpp"
 
 void reduceAndSolve(Instance& I, int d = 0);
 
@@ -10,26 +11,72 @@ void solveGreedy(Instance& I);
 #define PACE_EMS_FACTOR 1
 #endif
 
+// Solve the remaining instance exactly with the MaxSAT / ILP backends compiled into this build. If
+// there are several, they race on separate threads and the first optimal solution is taken, the
+// environment variable PACE_SOLVERS (a comma-separated list of backend names) restricts the choice.
+// EvalMaxSAT cannot be cancelled and is only used if no other backend is selected.
+void solveExact(Instance& I);
+
+// whether solveExact races the backend of the given name, i.e. it is compiled in and selected
+bool exactBackendSelected(const char* name);
+
+// The backends only read I and put the solution into DS. They return false if they were cancelled
+// before finding an optimal solution and throw if they fail otherwise.
 #ifdef USE_EVALMAXSAT
-void solveEvalMaxSat(Instance& I);
+bool solveEvalMaxSat(Instance& I, DominatingSet& DS, Cancellation& cancel);
 #endif
 
 #ifdef USE_ORTOOLS
-void solvecpsat(Instance& I);
+bool solvecpsat(Instance& I, DominatingSet& DS, Cancellation& cancel);
 #endif
 
 #ifdef USE_UWRMAXSAT
-void solveIPAMIR(Instance& I);
+bool solveIPAMIR(Instance& I, DominatingSet& DS, Cancellation& cancel);
+#endif
+
+// The leaf block subinstances of the BC tree reduction, which only differ in whether the cut vertex
+// is already dominated from outside the block, unconstrained, or forced into the DS.
+enum class CutVertexCase { DOMINATED, FREE, IN_DS };
+
+#ifdef USE_UWRMAXSAT
+// Encodes an instance once into an incremental IPAMIR solver and solves it for every CutVertexCase
+// of the vertex cv under assumptions, so that learned clauses and cores are shared between them.
+class CutVertexSolver {
+	Instance& I;
+	ogdf::node cv;
+	ogdf::NodeArray<int> var;
+	int activation;
+	void* ipamir;
+
+public:
+	CutVertexSolver(Instance& I, ogdf::node cv);
+	~CutVertexSolver();
+
+	CutVertexSolver(const CutVertexSolver&) = delete;
+	CutVertexSolver& operator=(const CutVertexSolver&) = delete;
+
+	// add an optimal DS of the instance in the given case to DS, returns false and leaves DS
+	// unchanged if cancel was requested before the solver finished
+	bool solve(CutVertexCase c, DominatingSet& DS, Cancellation& cancel);
+};
 #endif
 
 #ifdef USE_GUROBI
-void solveGurobiExactGurobi(Instance& instance);
+bool solveGurobiExactGurobi(Instance& instance, DominatingSet& DS, Cancellation& cancel);
 #endif
 
 #ifdef SAT_CACHE
+// The solution cache is only accessed by solveExact, the backends never see it: the solution is
+// looked up before the race and only the winner's solution is stored.
+std::vector<std::vector<int>> sat_cache_clauses(Instance& I);
 uint64_t hash_clauses(const std::vector<std::vector<int>>& clauses);
 void dump_sat(const std::string& file, const std::vector<std::vector<int>>& clauses);
 bool is_same_sat(const std::string& file, const std::vector<std::vector<int>>& clauses);
+std::string find_cache_file(const std::string& file);
 std::string get_filename(uint64_t hash, const std::string& ext, const std::string& dir = "cache/");
-bool try_load_solution(Instance& I, std::vector<std::vector<int>>& hclauses, std::string& filename);
+// fills DS and returns true on a hit, otherwise sets filename to where store_solution() writes
+bool try_load_solution(
+		DominatingSet& DS, std::vector<std::vector<int>>& hclauses, std::string& filename);
+void store_solution(const std::string& filename, const std::vector<std::vector<int>>& hclauses,
+		const DominatingSet& DS);
 #endif
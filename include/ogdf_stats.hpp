@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+// Per reduction rule and recursion depth counters. Collection is enabled by setting the environment
+// variable PACE_STATS to the path of the JSON report (or `-` for stderr), which is written by
+// writeReductionStats(). Otherwise, the only cost is one predictable branch per rule invocation.
+struct RuleCounters {
+	uint64_t calls = 0;
+	uint64_t applied = 0;
+	uint64_t nanos = 0;
+	int64_t nodes_removed = 0;
+	int64_t edges_removed = 0;
+	int64_t ds_added = 0;
+
+	RuleCounters& operator+=(const RuleCounters& o) {
+		calls += o.calls;
+		applied += o.applied;
+		nanos += o.nanos;
+		nodes_removed += o.nodes_removed;
+		edges_removed += o.edges_removed;
+		ds_added += o.ds_added;
+		return *this;
+	}
+};
+
+inline const char* reductionStatsPath() {
+	static const char* path = std::getenv("PACE_STATS");
+	return path;
+}
+
+inline bool reductionStatsEnabled() { return reductionStatsPath() != nullptr; }
+
+// thread-safe
+void recordReductionStats(const char* rule, int depth, const RuleCounters& counters);
+
+// write the collected counters as JSON, does nothing if PACE_STATS is not set
+void writeReductionStats();
+
+// Measures one invocation of a reduction rule on an instance providing G and DS. Rules that recurse
+// into reduceAndSolve (BC tree, Special2) include the time of the nested rules.
+template<typename Inst>
+class ScopedRuleTimer {
+	const Inst* inst = nullptr;
+	const char* rule;
+	int depth;
+	bool applied = false;
+	int64_t nodes = 0, edges = 0, ds = 0;
+	std::chrono::steady_clock::time_point start;
+
+public:
+	ScopedRuleTimer(const char* rule, int depth, const Inst& I) : rule(rule), depth(depth) {
+		if (reductionStatsEnabled()) {
+			inst = &I;
+			nodes = I.G.numberOfNodes();
+			edges = I.G.numberOfEdges();
+			ds = I.DS.size();
+			start = std::chrono::steady_clock::now();
+		}
+	}
+
+	ScopedRuleTimer(const ScopedRuleTimer&) = delete;
+	ScopedRuleTimer& operator=(const ScopedRuleTimer&) = delete;
+
+	// pass through the result of the rule
+	bool operator()(bool result) {
+		applied = result;
+		return result;
+	}
+
+	~ScopedRuleTimer() {
+		if (inst == nullptr) {
+			return;
+		}
+		RuleCounters c;
+		c.calls = 1;
+		c.applied = applied;
+		c.nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start)
+						  .count();
+		c.nodes_removed = nodes - (int64_t)inst->G.numberOfNodes();
+		c.edges_removed = edges - (int64_t)inst->G.numberOfEdges();
+		c.ds_added = (int64_t)inst->DS.size() - ds;
+		recordReductionStats(rule, depth, c);
+	}
+};
@@ -1,91 +1,85 @@
 #pragma once
-#include <set>
 
+#include <cstdint>
+#include <vector>
+
+#include "ogdf_bucketqueue.hpp"
 #include "ogdf_instance.hpp"
+#include "ogdf_partition.hpp"
 #include "ogdf_util.hpp"
 
 enum class RefineType { Subsume, Dominate };
 
+// Subsumption and domination by neighbourhood subsets in one pass. The "can dominate" relation is
+// read from the graph once into flat arrays over local ids, and both partition refinements run on
+// it with the same scratch memory: Subsume refines the candidates by the targets they can dominate,
+// then Dominate refines the targets by the candidates that can dominate them and are not subsumed,
+// which is the relation it would find in the graph after Subsume. Nodes that end up subsumed and
+// dominated are deleted right away and only referred to by their local id afterwards.
 class SubsetRefine {
-	RefineType type;
 	Instance& instance;
 
-	ogdf::Graph& G;
-	ogdf::NodeArray<std::vector<ogdf::node>> needRefineBy;
-	ogdf::NodeArray<size_t> needRefineBySize;
-	std::set<std::pair<size_t, ogdf::node>> needTouch;
-	ogdf::Graph refineG;
-	ogdf::NodeArray<ogdf::node> bagof; // node(G) -> node(refineG)
-	ogdf::NodeArray<std::vector<ogdf::node>> bagNodeVec; // node(refineG) -> list of contained nodes from G
-	ogdf::NodeArray<size_t> vecIndex; // node(G) -> index of node in its vector for swap and pop
-	ogdf::NodeArray<ogdf::node> refinedBag; // node(refineG) -> pointer to node which contains the elements that got refined
-	size_t cntedgesadded = 0;
-	ogdf::NodeArray<size_t> cnttouched;
-	size_t cntreduced = 0;
+	std::vector<ogdf::node> nodes; // local id -> node, nullptr once deleted
+	std::vector<uint8_t> subsumed, dominated;
+	// the targets of candidate c are out_adj[out_begin[c]], ..., out_adj[out_begin[c+1]-1], the
+	// candidates of target t likewise in in_adj
+	std::vector<size_t> out_begin, in_begin;
+	std::vector<int> out_adj, in_adj;
 
-public:
-	SubsetRefine(Instance& instance, RefineType type)
-		: instance(instance)
-		, G(instance.G)
-		, bagof(G, nullptr)
-		, bagNodeVec(refineG)
-		, vecIndex(G, 0)
-		, refinedBag(refineG, nullptr)
-		, type(type)
-		, cnttouched(G, 0) { }
-
-	void init() {
-		auto initbag = refineG.newNode();
-		needRefineBy.init(G, std::vector<ogdf::node>());
-		needRefineBySize.init(G, 0);
-		for (auto u : G.nodes) {
-			if ((!instance.is_dominated(u) && type == RefineType::Dominate)
-					|| (!instance.is_subsumed(u) && type == RefineType::Subsume)) {
-				bagof[u] = initbag;
-				bagNodeVec[initbag].push_back(u);
-				vecIndex[u] = bagNodeVec[initbag].size() - 1;
-
-				if (type == RefineType::Subsume) {
-					instance.forAllCanDominate(u, [&](ogdf::node adj) {
-						needRefineBy[u].push_back(adj);
-						return true;
-					});
-				} else {
-					instance.forAllCanBeDominatedBy(u, [&](ogdf::node adj) {
-						needRefineBy[u].push_back(adj);
-						return true;
-					});
-				}
-				needTouch.insert({needRefineBy[u].size(), u});
-				needRefineBySize[u] = needRefineBy[u].size();
-			}
-		}
+	RefineType type = RefineType::Subsume;
+	// the key of a node is the number of nodes that still have to refine by it
+	BucketQueue needTouch;
+	// the bags of the nodes that were refined by the same nodes so far
+	PartitionRefinement bags;
+	// the nodes u still has to be refined by are the first needRefineByEnd[u] of its relation
+	std::vector<size_t> needRefineByEnd;
+	std::vector<uint8_t> isrefinedby;
+	std::vector<int> nodesToTouch;
+	size_t cntsubsumed = 0;
+	size_t cntdominated = 0;
+	size_t cntremoved = 0;
+
+	// the nodes that u is refined by (Subsume: its targets, Dominate: its candidates)
+	const int* refinedByBegin(int u) const {
+		return type == RefineType::Subsume ? out_adj.data() + out_begin[u]
+										   : in_adj.data() + in_begin[u];
+	}
+
+	const int* refinedByEnd(int u) const {
+		return type == RefineType::Subsume ? out_adj.data() + out_begin[u + 1]
+										   : in_adj.data() + in_begin[u + 1];
+	}
+
+	// the nodes that refining by u touches (Subsume: its candidates, Dominate: its targets)
+	const int* touchesBegin(int u) const {
+		return type == RefineType::Subsume ? in_adj.data() + in_begin[u]
+										   : out_adj.data() + out_begin[u];
 	}
 
-	bool doReduce(ogdf::node u) {
-		// bool reduce = type == RefineType::Subsume || instance.is_subsumed[u];
-		bool reduce = true;
-		if (reduce) {
-			if (type == RefineType::Subsume) {
-				instance.markSubsumed(u);
-			} else {
-				instance.markDominated(u, false);
-			}
-			cntreduced++;
-		}
-		auto& vec = bagNodeVec[bagof[u]];
-		auto oldindex = vecIndex[u];
-		vecIndex[vec[vec.size() - 1]] = oldindex;
-		std::swap(vec[oldindex], vec[vec.size() - 1]);
-		vec.pop_back();
-		bagof[u] = nullptr;
-		if (needTouch.find({needRefineBySize[u], u}) != needTouch.end()) {
-			needTouch.erase({needRefineBySize[u], u});
-		}
-		return reduce;
+	const int* touchesEnd(int u) const {
+		return type == RefineType::Subsume ? in_adj.data() + in_begin[u + 1]
+										   : out_adj.data() + out_begin[u + 1];
 	}
 
-	size_t doRefinementReduction();
+	void read();
+
+	void init(RefineType t);
+
+	void doReduce(int u);
+
+	void doRefinementReduction();
+
+	void refineByNode(int u);
+
+public:
+	explicit SubsetRefine(Instance& instance) : instance(instance) { }
+
+	// read the relation, run both refinements and delete the nodes that are subsumed and dominated
+	void run();
+
+	size_t numberSubsumed() const { return cntsubsumed; }
+
+	size_t numberDominated() const { return cntdominated; }
 
-	void refineByNode(const ogdf::node& u);
+	size_t numberRemoved() const { return cntremoved; }
 };
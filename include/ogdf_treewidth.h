@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <csignal>
 #include <future>
@@ -11,15 +12,12 @@
 #include <ogdf/basic/GraphSets.h>
 #include <htd/main.hpp>
 
+#include "ogdf_dptable.hpp"
+#include "ogdf_elimination.hpp"
 #include "ogdf_instance.hpp"
+#include "ogdf_parallel.hpp"
 #include "ogdf_util.hpp"
 
-typedef size_t TW_SIGNATURE_TYPE;
-#define TW_WAITING 0
-#define TW_DOMINATED 1
-#define TW_INDS 2
-#define TW_QM 1
-
 struct hash_pair final {
 	template<class TFirst, class TSecond>
 	size_t operator()(const std::pair<TFirst, TSecond>& p) const noexcept {
@@ -34,29 +32,30 @@ class ReductionTreeDecomposition {
 public:
 	ogdf::Graph& G;
 	Instance& I;
+	// one htd management instance per heuristic of the portfolio, they outlive the results
+	std::vector<std::unique_ptr<htd::LibraryInstance>> managers;
 	htd::ITreeDecomposition* decomposition = nullptr;
-	htd::IMutableGraph* graph;
-	std::vector<std::unordered_map<TW_SIGNATURE_TYPE, std::tuple<size_t, TW_SIGNATURE_TYPE, TW_SIGNATURE_TYPE>>>
-			DP; // TODO: instead of unordered_map we could use vector, this would cost more memory
+	htd::IMutableGraph* graph = nullptr;
+	std::vector<DPTable> DP;
 	// std::vector<std::unordered_map<std::pair<TW_SIGNATURE_TYPE, size_t>, u_int64_t>> DPCNT;
 	std::vector<size_t> minkappa;
 	std::vector<std::vector<ogdf::node>> bag_nodes;
 	ogdf::NodeArray<size_t> nodeid;
 	std::vector<ogdf::node> idnode;
-	ogdf::NodeSet currBagNodes;
-	ogdf::NodeArray<size_t> currSigIndex;
 	std::vector<TW_SIGNATURE_TYPE> chosensig;
 	int treewidth = -1;
+	// worst case bytes of the DP, over all frozen tables plus the largest bag being computed
+	size_t dpMemoryEstimate = 0;
+	size_t dpMemoryPeakBag = 0;
 
 	ReductionTreeDecomposition(ogdf::Graph& G, Instance& instance)
 		: G(G)
 		, I(instance)
 		, nodeid(G, 0)
-		, idnode(G.numberOfNodes() + 1)
-		, currBagNodes(G)
-		, currSigIndex(G) { }
+		, idnode(G.numberOfNodes() + 1) { }
 
 	~ReductionTreeDecomposition() {
+		releaseDPMemory();
 		if (decomposition) {
 			delete decomposition;
 		}
@@ -65,11 +64,63 @@ public:
 		}
 	}
 
+	// Try greedy elimination orderings first, and the htd heuristics only if they do not find a
+	// width that is small enough for the DP. Nothing is computed if the treewidth is certainly
+	// too large.
 	void computeDecomposition();
 
+	bool hasDecomposition() const { return !bags.empty(); }
+
+	// Estimate the DP memory from the bag sizes. False if a single bag may already exceed the
+	// memory budget (PACE_DP_MEMORY_MB), so that the DP is not worth trying.
+	bool fitsDPMemory();
+
+	// -1 if the tables outgrew the memory budget
 	int solveDPExact();
 
 private:
+	enum class BagType { LEAF, INTRODUCE, FORGET, JOIN, COPY };
+
+	// The nice tree decomposition in plain arrays, from htd or from an elimination ordering, so
+	// that bags can be computed concurrently. Bag 0 is never used.
+	struct Bag {
+		BagType type = BagType::COPY;
+		htd::vertex_t parent = 0;
+		std::vector<htd::vertex_t> children;
+		// the introduced or forgotten vertex
+		ogdf::node vertex = nullptr;
+	};
+
+	std::vector<Bag> bags;
+	htd::vertex_t root_bag = htd::Vertex::UNKNOWN;
+
+	std::vector<size_t> dp_bytes;
+	size_t dp_bytes_total = 0;
+	size_t dp_memory_reserved = 0;
+	std::mutex dp_memory_mutex;
+	// set by initTable() if a table could not be allocated within the budget
+	std::atomic<bool> dp_over_budget {false};
+
+	// fill bags and bag_nodes from the htd decomposition
+	void collectBags();
+
+	void collectBags(const EliminationDecomposition& native);
+
+	// run the handler of the bag type, then free what is not needed any more
+	bool computeBag(htd::vertex_t curbag);
+
+	// drop what the backtracking does not need from the tables of the children of curbag
+	void freezeChildren(htd::vertex_t curbag);
+
+	// Reserve what DP[curbag].init(size, expected) allocates before calling it. Returns false and
+	// leaves the table alone if that exceeds the memory budget, the handler then has to stop.
+	bool initTable(htd::vertex_t curbag, size_t size, size_t expected);
+
+	// returns false if the tables do not fit into the memory budget any more
+	bool accountDPMemory(htd::vertex_t curbag);
+
+	void releaseDPMemory();
+
 	// size_t getCntDP(size_t bag, TW_SIGNATURE_TYPE sig, size_t cnt) {
 	// 	auto it = DPCNT[bag].find({sig, cnt});
 	// 	if (it != DPCNT[bag].end()) {
@@ -95,6 +146,9 @@ private:
 
 	void handleJoinNode(htd::vertex_t curbag);
 
+	// returns false if the arrays would be too large
+	bool handleJoinNodeArray(htd::vertex_t curbag);
+
 	void handleCopyNode(htd::vertex_t curbag);
 
 	void backTrackJoinNode(htd::vertex_t curbag);
@@ -2,10 +2,15 @@
 
 #include <chrono>
 #include <filesystem>
+#include <iostream>
+#include <mutex>
 
 #include <ogdf/basic/Graph.h>
 
-extern ogdf::Logger logger;
+#include "ogdf_hash.hpp"
+
+// every thread has its own logger, so that indentation and log levels do not interfere
+extern thread_local ogdf::Logger logger;
 
 #if defined(OGDF_DEBUG) || defined(PACE_LOG)
 #	define log   \
@@ -23,8 +28,11 @@ extern ogdf::Logger logger;
 		logger.lout(ogdf::Logger::Level::Minor)
 #endif
 
+// The visitors are templates so that the callbacks can be inlined into the (often nested) loops.
+// They stop as soon as the callback returns false and return whether they visited all adjEntries.
 #ifdef OGDF_DEBUG
-inline bool forAllOutAdj(ogdf::node v, std::function<bool(ogdf::adjEntry)> f) {
+template<typename F>
+inline bool forAllOutAdj(ogdf::node v, F&& f) {
 	OGDF_ASSERT(v->outdeg() == 0 || v->adjEntries.head()->isSource());
 	OGDF_ASSERT(v->indeg() == 0 || !v->adjEntries.tail()->isSource());
 	size_t c = 0;
@@ -53,7 +61,8 @@ inline bool forAllOutAdj(ogdf::node v, std::function<bool(ogdf::adjEntry)> f) {
 	return call;
 }
 
-inline bool forAllInAdj(ogdf::node v, std::function<bool(ogdf::adjEntry)> f) {
+template<typename F>
+inline bool forAllInAdj(ogdf::node v, F&& f) {
 	OGDF_ASSERT(v->outdeg() == 0 || v->adjEntries.head()->isSource());
 	OGDF_ASSERT(v->indeg() == 0 || !v->adjEntries.tail()->isSource());
 	size_t c = 0;
@@ -81,7 +90,8 @@ inline bool forAllInAdj(ogdf::node v, std::function<bool(ogdf::adjEntry)> f) {
 	return call;
 }
 #else
-inline bool forAllOutAdj(ogdf::node v, std::function<bool(ogdf::adjEntry)> f) {
+template<typename F>
+inline bool forAllOutAdj(ogdf::node v, F&& f) {
 	for (auto adj_it = (v)->adjEntries.begin(); adj_it != (v)->adjEntries.end();) {
 		auto adj = *adj_it;
 		++adj_it;
@@ -95,7 +105,8 @@ inline bool forAllOutAdj(ogdf::node v, std::function<bool(ogdf::adjEntry)> f) {
 	return true;
 }
 
-inline bool forAllInAdj(ogdf::node v, std::function<bool(ogdf::adjEntry)> f) {
+template<typename F>
+inline bool forAllInAdj(ogdf::node v, F&& f) {
 	for (auto adj_it = (v)->adjEntries.rbegin(); adj_it != (v)->adjEntries.rend();) {
 		auto adj = *adj_it;
 		++adj_it;
@@ -110,6 +121,30 @@ inline bool forAllInAdj(ogdf::node v, std::function<bool(ogdf::adjEntry)> f) {
 }
 #endif
 
+// Silences std::cout while at least one instance exists, also if several threads use it at once.
+class QuietStdout {
+	inline static std::mutex mutex;
+	inline static int count = 0;
+
+public:
+	QuietStdout() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (count++ == 0) {
+			std::cout.setstate(std::ios::failbit); // https://stackoverflow.com/a/8246430
+		}
+	}
+
+	~QuietStdout() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--count == 0) {
+			std::cout.clear();
+		}
+	}
+
+	QuietStdout(const QuietStdout&) = delete;
+	QuietStdout& operator=(const QuietStdout&) = delete;
+};
+
 namespace internal {
 ogdf::node idn(ogdf::node n);
 ogdf::edge ide(ogdf::edge n);
@@ -117,17 +152,3 @@ ogdf::edge ide(ogdf::edge n);
 
 #define SMALL_BLOCK 100
 #define BLOCK_FRACTION 0.25f
-
-constexpr uint64_t FNV1a_64_SEED = 0xcbf29ce484222325UL;
-
-// https://stackoverflow.com/a/77342581
-inline void FNV1a_64_update(uint64_t& h, uint64_t v) {
-	h ^= v;
-	h *= 0x00000100000001B3UL;
-}
-
-inline uint64_t FNV1a_64_one(uint64_t v) {
-	uint64_t ret = FNV1a_64_SEED;
-	FNV1a_64_update(ret, v);
-	return ret;
-}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ogdf_parallel.hpp"
+
+// Limits of the exact vertex cover search, checked cooperatively while branching.
+struct VertexCoverLimits {
+	long branches = 100000000;
+	double seconds = 3600;
+};
+
+// the solver works on fixed-size global arrays
+constexpr int VC_MAX_VERTICES = 10000;
+
+// Undirected graph on the vertices 0, ..., n - 1 in compressed sparse row form. The neighbours of v
+// are adj[begin[v]], ..., adj[begin[v+1]-1] in ascending order, without duplicates or loops, so
+// every edge is stored once in each direction.
+struct ConflictGraph {
+	std::vector<uint64_t> begin {0};
+	std::vector<uint32_t> adj;
+
+	uint32_t numberOfNodes() const { return begin.size() - 1; }
+
+	uint64_t numberOfEdges() const { return adj.size() / 2; }
+};
+
+// Build G on n vertices in parallel, neighbours(v, out) appends the neighbours of v to out and may
+// report them several times or include v itself. Every thread deduplicates with a marker array and
+// writes the sorted neighbourhoods of its consecutive vertices into one buffer, which is then
+// copied to its final position once the degrees are known.
+template<typename F>
+void buildConflictGraph(uint32_t n, F&& neighbours, ConflictGraph& G) {
+	constexpr uint32_t UNMARKED = std::numeric_limits<uint32_t>::max();
+	std::vector<uint64_t> degree(n);
+	std::mutex parts_mutex;
+	std::vector<std::pair<size_t, std::vector<uint32_t>>> parts;
+	// at most one part per thread, so that the marker arrays take O(n) per thread
+	size_t grain = std::max<size_t>(1024, (n + paceThreads() - 1) / paceThreads());
+	parallelRanges(n, grain, [&](size_t begin, size_t end) {
+		std::vector<uint32_t> mark(n, UNMARKED), found, adj;
+		for (size_t v = begin; v < end; ++v) {
+			found.clear();
+			neighbours((uint32_t)v, found);
+			size_t start = adj.size();
+			for (uint32_t w : found) {
+				if (w != v && mark[w] != v) {
+					mark[w] = v;
+					adj.push_back(w);
+				}
+			}
+			std::sort(adj.begin() + start, adj.end());
+			degree[v] = adj.size() - start;
+		}
+		std::lock_guard<std::mutex> lock(parts_mutex);
+		parts.emplace_back(begin, std::move(adj));
+	});
+
+	G.begin.assign(n + 1, 0);
+	for (uint32_t v = 0; v < n; ++v) {
+		G.begin[v + 1] = G.begin[v] + degree[v];
+	}
+	G.adj.resize(G.begin[n]);
+	parallelRanges(parts.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t p = begin; p < end; ++p) {
+			auto& [first, adj] = parts[p];
+			std::copy(adj.begin(), adj.end(), G.adj.begin() + G.begin[first]);
+		}
+	});
+}
+
+// Minimum vertex cover of G, computed in process by the bundled MoMC clique solver as the
+// complement of a maximum clique of the complement graph. Returns false if a limit was hit or the
+// graph is too large. The solver keeps its state in globals, so concurrent calls run one after the
+// other.
+bool solveVertexCover(
+		const ConflictGraph& G, const VertexCoverLimits& limits, std::vector<int>& cover);
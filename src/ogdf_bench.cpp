@@ -0,0 +1,343 @@
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <set>
+
+#include "ogdf_bucketqueue.hpp"
+#include "ogdf_csr.hpp"
+#include "ogdf_instance.hpp"
+#include "ogdf_parallel.hpp"
+#include "ogdf_subsetrefine.hpp"
+#include "ogdf_util.hpp"
+
+thread_local ogdf::Logger logger;
+
+ogdf::node internal::idn(ogdf::node n) { return n; }
+
+ogdf::edge internal::ide(ogdf::edge n) { return n; }
+
+static int repetitions = 3;
+
+// best-of-`repetitions` wall time in seconds
+static double timeBest(const std::function<void()>& f) {
+	double best = std::numeric_limits<double>::max();
+	for (int r = 0; r < repetitions; ++r) {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto end = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double>(end - start).count());
+	}
+	return best;
+}
+
+static void report(const std::string& what, size_t bytes, double secs) {
+	std::cout << "  " << std::left << std::setw(24) << what << std::right << std::fixed
+			  << std::setprecision(3) << std::setw(10) << secs * 1000 << " ms " << std::setw(10)
+			  << std::setprecision(1) << (bytes / 1e6) / secs << " MB/s" << std::endl;
+}
+
+// number tokens seen, so that the compiler cannot drop the scanning loops
+static volatile size_t sink;
+
+static int benchParse(int argc, char** argv) {
+	for (int i = 0; i < argc; ++i) {
+		InputBuffer buf;
+		if (!buf.openFile(argv[i])) {
+			std::cerr << "Error opening file " << argv[i] << std::endl;
+			return 1;
+		}
+		std::cout << argv[i] << ": " << std::fixed << std::setprecision(1) << buf.size() / 1e6
+				  << " MB" << std::endl;
+
+		report("getline+istringstream", buf.size(), timeBest([&] {
+			std::istringstream is(std::string(buf.begin(), buf.end()));
+			std::string line;
+			size_t cnt = 0;
+			while (std::getline(is, line)) {
+				if (line.empty() || line[0] == 'c' || line[0] == 'p') {
+					continue;
+				}
+				std::istringstream iss(line);
+				unsigned int u;
+				while (iss >> u) {
+					cnt += u;
+				}
+			}
+			sink = cnt;
+		}));
+
+		report("LineScanner", buf.size(), timeBest([&] {
+			LineScanner sc(buf.begin(), buf.end());
+			size_t cnt = 0;
+			if (sc.nextDataLine()) {
+				sc.skipLine(); // header
+			}
+			while (sc.nextDataLine()) {
+				unsigned int u;
+				while (sc.readUInt(u)) {
+					cnt += u;
+				}
+				sc.skipLine();
+			}
+			sink = cnt;
+		}));
+
+		for (unsigned int threads = 1;; threads = std::min(threads * 2, paceThreads())) {
+			report("parseInstanceCSR x" + std::to_string(threads), buf.size(), timeBest([&] {
+				InstanceCSR csr;
+				parseInstanceCSR(buf, csr, threads);
+				sink = csr.numArcs();
+			}));
+			if (threads == paceThreads()) {
+				break;
+			}
+		}
+
+		report("Instance::read", buf.size(), timeBest([&] {
+			Instance I;
+			I.read(buf);
+			sink = I.G.numberOfEdges();
+		}));
+	}
+	return 0;
+}
+
+// the visitors as they were before they became templates, as baseline for benchAdj
+static bool forAllOutAdjErased(ogdf::node v, std::function<bool(ogdf::adjEntry)> f) {
+	for (auto adj_it = (v)->adjEntries.begin(); adj_it != (v)->adjEntries.end();) {
+		auto adj = *adj_it;
+		++adj_it;
+		if (!adj->isSource()) {
+			return true;
+		}
+		if (!f(adj)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool forAllInAdjErased(ogdf::node v, std::function<bool(ogdf::adjEntry)> f) {
+	for (auto adj_it = (v)->adjEntries.rbegin(); adj_it != (v)->adjEntries.rend();) {
+		auto adj = *adj_it;
+		++adj_it;
+		if (adj->isSource()) {
+			return true;
+		}
+		if (!f(adj)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void reportPerVisit(const std::string& what, size_t visits, double secs) {
+	std::cout << "  " << std::left << std::setw(24) << what << std::right << std::fixed
+			  << std::setprecision(3) << std::setw(10) << secs * 1000 << " ms " << std::setw(10)
+			  << std::setprecision(2) << secs * 1e9 / visits << " ns/visit" << std::endl;
+}
+
+// per-edge cost of the neighbourhood visitors, once flat and once nested two levels deep as in
+// the subsumption rules
+static int benchAdj(int argc, char** argv) {
+	for (int i = 0; i < argc; ++i) {
+		InputBuffer buf;
+		if (!buf.openFile(argv[i])) {
+			std::cerr << "Error opening file " << argv[i] << std::endl;
+			return 1;
+		}
+		Instance I;
+		I.read(buf);
+		std::cout << argv[i] << ": " << I.G.numberOfNodes() << " nodes, " << I.G.numberOfEdges()
+				  << " edges" << std::endl;
+
+		size_t flat = 0, nested = 0;
+		for (auto v : I.G.nodes) {
+			flat += v->degree();
+			forAllOutAdj(v, [&](ogdf::adjEntry adj) {
+				nested += adj->twinNode()->indeg();
+				return true;
+			});
+		}
+
+		auto flatLoop = [&](auto&& outAdj, auto&& inAdj) {
+			size_t cnt = 0;
+			for (auto v : I.G.nodes) {
+				outAdj(v, [&](ogdf::adjEntry adj) {
+					cnt += adj->twinNode()->index();
+					return true;
+				});
+				inAdj(v, [&](ogdf::adjEntry adj) {
+					cnt += adj->twinNode()->index();
+					return true;
+				});
+			}
+			sink = cnt;
+		};
+		auto nestedLoop = [&](auto&& outAdj, auto&& inAdj) {
+			size_t cnt = 0;
+			for (auto v : I.G.nodes) {
+				outAdj(v, [&](ogdf::adjEntry adj) {
+					return inAdj(adj->twinNode(), [&](ogdf::adjEntry adj2) {
+						cnt += adj2->twinNode()->index();
+						return true;
+					});
+				});
+			}
+			sink = cnt;
+		};
+		auto erasedOut = [](ogdf::node v, auto&& f) { return forAllOutAdjErased(v, f); };
+		auto erasedIn = [](ogdf::node v, auto&& f) { return forAllInAdjErased(v, f); };
+		auto templOut = [](ogdf::node v, auto&& f) { return forAllOutAdj(v, f); };
+		auto templIn = [](ogdf::node v, auto&& f) { return forAllInAdj(v, f); };
+
+		reportPerVisit("std::function", flat, timeBest([&] { flatLoop(erasedOut, erasedIn); }));
+		reportPerVisit("template", flat, timeBest([&] { flatLoop(templOut, templIn); }));
+		reportPerVisit("std::function nested", nested,
+				timeBest([&] { nestedLoop(erasedOut, erasedIn); }));
+		reportPerVisit("template nested", nested, timeBest([&] { nestedLoop(templOut, templIn); }));
+	}
+	return 0;
+}
+
+// the cheap reduction loop on the ogdf::Graph vs. on the FlatGraph (including building the kernel)
+static int benchReduce(int argc, char** argv) {
+	for (int i = 0; i < argc; ++i) {
+		InputBuffer buf;
+		if (!buf.openFile(argv[i])) {
+			std::cerr << "Error opening file " << argv[i] << std::endl;
+			return 1;
+		}
+		std::cout << argv[i] << ": " << std::fixed << std::setprecision(1) << buf.size() / 1e6
+				  << " MB" << std::endl;
+		ogdf::Logger::globalLogLevel(ogdf::Logger::Level::Alarm);
+
+		report("ogdf::Graph", buf.size(), timeBest([&] {
+			Instance I;
+			I.read(buf);
+			bool changed = true;
+			while (changed) {
+				changed = false;
+				while (I.reductionExtremeDegrees()) {
+					changed = true;
+				}
+				if (I.reductionContraction()) {
+					changed = true;
+				}
+			}
+			sink = I.G.numberOfEdges();
+		}));
+
+		report("FlatGraph", buf.size(), timeBest([&] {
+			FlatInstance F;
+			F.read(buf);
+			F.reduce();
+			Instance I;
+			I.initFromFlat(F);
+			sink = I.G.numberOfEdges();
+		}));
+	}
+	return 0;
+}
+
+// Subsume and Dominate refinement as in reductionNeighborhoodSubsets, timed without reading the
+// instance, and their queue access pattern (take a node of minimum key, decrease the keys of its
+// in-neighbours) replayed on the std::set it used before and on the bucket queue.
+static int benchSubsets(int argc, char** argv) {
+	for (int i = 0; i < argc; ++i) {
+		InputBuffer buf;
+		if (!buf.openFile(argv[i])) {
+			std::cerr << "Error opening file " << argv[i] << std::endl;
+			return 1;
+		}
+		ogdf::Logger::globalLogLevel(ogdf::Logger::Level::Alarm);
+		Instance I;
+		I.read(buf);
+		std::cout << argv[i] << ": " << I.G.numberOfNodes() << " nodes, " << I.G.numberOfEdges()
+				  << " edges" << std::endl;
+		size_t touches = I.G.numberOfEdges();
+
+		auto replaySet = [&] {
+			ogdf::NodeArray<size_t> key(I.G);
+			std::set<std::pair<size_t, ogdf::node>> queue;
+			for (auto v : I.G.nodes) {
+				key[v] = v->indeg();
+				queue.insert({key[v], v});
+			}
+			while (!queue.empty()) {
+				auto v = queue.begin()->second;
+				queue.erase(queue.begin());
+				forAllInAdj(v, [&](ogdf::adjEntry adj) {
+					auto u = adj->twinNode();
+					if (queue.erase({key[u], u}) > 0) {
+						queue.insert({--key[u], u});
+					}
+					return true;
+				});
+			}
+		};
+		auto replayBuckets = [&] {
+			BucketQueue queue(I.G.maxNodeIndex() + 1);
+			std::vector<ogdf::node> byIndex(I.G.maxNodeIndex() + 1);
+			for (auto v : I.G.nodes) {
+				byIndex[v->index()] = v;
+				queue.insert(v->index(), v->indeg());
+			}
+			while (!queue.empty()) {
+				auto v = byIndex[queue.min()];
+				queue.remove(v->index());
+				forAllInAdj(v, [&](ogdf::adjEntry adj) {
+					if (queue.contains(adj->twinNode()->index())) {
+						queue.decrease(adj->twinNode()->index());
+					}
+					return true;
+				});
+			}
+		};
+		reportPerVisit("std::set replay", touches, timeBest(replaySet));
+		reportPerVisit("BucketQueue replay", touches, timeBest(replayBuckets));
+
+		// the refinement changes the instance, so it is read again for every repetition
+		double best = std::numeric_limits<double>::max();
+		size_t reduced = 0;
+		for (int r = 0; r < repetitions; ++r) {
+			Instance J;
+			J.read(buf);
+			auto start = std::chrono::steady_clock::now();
+			SubsetRefine refine(J);
+			refine.run();
+			reduced = refine.numberSubsumed() + refine.numberDominated();
+			auto end = std::chrono::steady_clock::now();
+			best = std::min(best, std::chrono::duration<double>(end - start).count());
+		}
+		reportPerVisit("SubsetRefine", touches, best);
+		std::cout << "  " << reduced << " nodes subsumed or dominated" << std::endl;
+	}
+	return 0;
+}
+
+static const std::map<std::string, std::function<int(int, char**)>> benchmarks = {
+		{"adj", benchAdj},
+		{"parse", benchParse},
+		{"reduce", benchReduce},
+		{"subsets", benchSubsets},
+};
+
+int main(int argc, char** argv) {
+	int argi = 1;
+	if (argi + 1 < argc && std::string(argv[argi]) == "-r") {
+		repetitions = std::max(1, std::stoi(argv[argi + 1]));
+		argi += 2;
+	}
+	auto it = argi < argc ? benchmarks.find(argv[argi]) : benchmarks.end();
+	if (it == benchmarks.end()) {
+		std::cerr << "Usage: " << argv[0] << " [-r repetitions] <benchmark> [args...]\n"
+				  << "Benchmarks:\n"
+				  << "  adj file.gr...     per-edge cost of the neighbourhood visitors\n"
+				  << "  parse file.gr...   input parsing throughput\n"
+				  << "  reduce file.gr...  cheap reductions on ogdf::Graph vs. FlatGraph\n"
+				  << "  subsets file.gr... subset refinement and its priority queue" << std::endl;
+		return 1;
+	}
+	return it->second(argc - argi - 1, argv + argi + 1);
+}
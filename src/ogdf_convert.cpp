@@ -0,0 +1,72 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "ogdf_csr.hpp"
+#include "ogdf_parallel.hpp"
+
+// Converts between the textual PACE formats and the binary instance format, see ogdf_csr.hpp.
+
+static int usage(const char* name) {
+	std::cerr << "Usage: " << name << " file.gr|file.hs out.bin   convert to binary\n"
+			  << "       " << name << " --text file.bin out.gr    convert back to text\n"
+			  << "       " << name << " --verify file.bin         check header and payload checksums"
+			  << std::endl;
+	return 1;
+}
+
+static bool load(const char* path, InstanceCSR& csr, bool verify) {
+	InputBuffer buf;
+	if (!buf.openFile(path)) {
+		std::cerr << "Error opening file " << path << std::endl;
+		return false;
+	}
+	if (isBinaryInstance(buf)) {
+		loadInstanceBinary(std::move(buf), csr, verify);
+	} else {
+		parseInstanceCSR(buf, csr, paceThreads());
+	}
+	return true;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		return usage(argv[0]);
+	}
+	std::string mode = argv[1];
+	InstanceCSR csr;
+	if (mode == "--verify") {
+		if (argc != 3) {
+			return usage(argv[0]);
+		}
+		InputBuffer buf;
+		if (!buf.openFile(argv[2])) {
+			std::cerr << "Error opening file " << argv[2] << std::endl;
+			return 1;
+		}
+		if (!isBinaryInstance(buf)) {
+			std::cerr << argv[2] << " is not a binary instance" << std::endl;
+			return 1;
+		}
+		loadInstanceBinary(std::move(buf), csr, true);
+		std::cout << "OK: " << csr.type << " instance with " << csr.n << " vertices, " << csr.m
+				  << (csr.type == "hs" ? " hyperedges" : " edges") << std::endl;
+		return 0;
+	}
+
+	bool toText = mode == "--text";
+	if (argc != (toText ? 4 : 3)) {
+		return usage(argv[0]);
+	}
+	const char* in = argv[toText ? 2 : 1];
+	const char* out = argv[toText ? 3 : 2];
+	if (!load(in, csr, false)) {
+		return 1;
+	}
+	std::ofstream os(out, toText ? std::ios::out : std::ios::out | std::ios::binary);
+	if (!os || !(toText ? writeInstanceText(csr, os) : writeInstanceBinary(csr, os))) {
+		std::cerr << "Error writing " << out << std::endl;
+		return 1;
+	}
+	return 0;
+}
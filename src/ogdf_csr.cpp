@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+#include "ogdf_csr.hpp"
+#include "ogdf_hash.hpp"
+#include "ogdf_parallel.hpp"
+
+// do not bother spawning threads for less input than this per thread
+constexpr size_t MIN_CHUNK_SIZE = 4 << 20;
+
+[[noreturn]] static void csrInputError(const std::string& msg) {
+	std::cerr << "Error reading input: " << msg << std::endl;
+	std::exit(1);
+}
+
+template<typename T>
+static inline void atomicInc(T& v) {
+	__atomic_fetch_add(&v, 1, __ATOMIC_RELAXED);
+}
+
+template<typename T>
+static inline T atomicFetchInc(T& v) {
+	return __atomic_fetch_add(&v, 1, __ATOMIC_RELAXED);
+}
+
+static void prefixSum(std::vector<uint64_t>& offsets) {
+	uint64_t sum = 0;
+	for (auto& o : offsets) {
+		uint64_t d = o;
+		o = sum;
+		sum += d;
+	}
+}
+
+void parseInstanceCSR(const InputBuffer& buf, InstanceCSR& csr, unsigned int threads) {
+	LineScanner sc(buf.begin(), buf.end());
+	unsigned int n, m;
+	if (!sc.nextDataLine() || sc.readToken() != "p") {
+		csrInputError("missing header line `p (ds|hs) [0-9]+ [0-9]+`");
+	}
+	csr.type = sc.readToken();
+	if (!sc.readUInt(n) || !sc.readUInt(m)) {
+		csrInputError("bad header line " + std::string(sc.currentLine()));
+	}
+	sc.skipLine();
+	bool hs;
+	if (csr.type == "ds") {
+		hs = false;
+	} else if (csr.type == "hs") {
+		hs = true;
+	} else {
+		csrInputError("unknown input type " + csr.type);
+	}
+	csr.n = n;
+	csr.m = m;
+	csr.numNodes = hs ? n + m : n;
+
+	// split the remaining input at line boundaries
+	const char* data = sc.pos();
+	const char* end = buf.end();
+	threads = std::max(1u, std::min<unsigned int>(threads, (end - data) / MIN_CHUNK_SIZE));
+	std::vector<const char*> bounds(threads + 1);
+	bounds[0] = data;
+	bounds[threads] = end;
+	for (unsigned int t = 1; t < threads; ++t) {
+		const char* p = std::max(bounds[t - 1], data + (end - data) / threads * t);
+		while (p < end && p[-1] != '\n') {
+			++p;
+		}
+		bounds[t] = p;
+	}
+
+	// first pass: count lines and degrees
+	// (the offset vectors temporarily hold the degree of node x at index x - 1)
+	csr.outOffsetsStore.assign(csr.numNodes + 1, 0);
+	csr.inOffsetsStore.assign(csr.numNodes + 1, 0);
+	std::vector<uint64_t> chunkLines(threads + 1, 0);
+	std::vector<std::vector<uint32_t>> chunkLineLengths(threads);
+	std::atomic<bool> error(false);
+	parallelFor(threads, [&](unsigned int t) {
+		LineScanner sc(bounds[t], bounds[t + 1]);
+		uint64_t lines = 0;
+		while (sc.nextDataLine()) {
+			unsigned int u, v;
+			if (hs) {
+				uint32_t len = 0;
+				while (sc.readUInt(u)) {
+					if (u < 1 || u > n) {
+						error = true;
+						return;
+					}
+					atomicInc(csr.outOffsetsStore[u - 1]);
+					++len;
+				}
+				chunkLineLengths[t].push_back(len);
+			} else {
+				if (!sc.readUInt(u) || !sc.readUInt(v) || u < 1 || u > n || v < 1 || v > n) {
+					error = true;
+					return;
+				}
+				atomicInc(csr.outOffsetsStore[u - 1]);
+				atomicInc(csr.inOffsetsStore[v - 1]);
+			}
+			sc.skipLine();
+			++lines;
+		}
+		chunkLines[t + 1] = lines;
+	});
+	if (error) {
+		csrInputError("bad edge line");
+	}
+	for (unsigned int t = 0; t < threads; ++t) {
+		chunkLines[t + 1] += chunkLines[t];
+	}
+	if (chunkLines[threads] != m) {
+		csrInputError("expected " + std::to_string(m) + " edge lines, found "
+				+ std::to_string(chunkLines[threads]));
+	}
+	if (hs) {
+		for (unsigned int t = 0; t < threads; ++t) {
+			auto h = n + chunkLines[t];
+			for (auto len : chunkLineLengths[t]) {
+				csr.inOffsetsStore[h++] = len;
+			}
+		}
+		chunkLineLengths.clear();
+	}
+	prefixSum(csr.outOffsetsStore);
+	prefixSum(csr.inOffsetsStore);
+	uint64_t arcs = csr.outOffsetsStore[csr.numNodes];
+	if (arcs != csr.inOffsetsStore[csr.numNodes]) {
+		csrInputError("inconsistent degrees");
+	}
+
+	// second pass: fill the adjacency arrays
+	csr.outTargetsStore.resize(arcs);
+	csr.inSourcesStore.resize(arcs);
+	std::vector<uint64_t> outCursor(csr.outOffsetsStore.begin(), csr.outOffsetsStore.end() - 1);
+	std::vector<uint64_t> inCursor(csr.inOffsetsStore.begin(), csr.inOffsetsStore.end() - 1);
+	parallelFor(threads, [&](unsigned int t) {
+		LineScanner sc(bounds[t], bounds[t + 1]);
+		uint32_t h = n + chunkLines[t];
+		while (sc.nextDataLine()) {
+			unsigned int u = 0, v = 0;
+			if (hs) {
+				++h;
+				while (sc.readUInt(u)) {
+					csr.outTargetsStore[atomicFetchInc(outCursor[u - 1])] = h;
+					csr.inSourcesStore[inCursor[h - 1]++] = u;
+				}
+			} else {
+				sc.readUInt(u);
+				sc.readUInt(v);
+				csr.outTargetsStore[atomicFetchInc(outCursor[u - 1])] = v;
+				csr.inSourcesStore[atomicFetchInc(inCursor[v - 1])] = u;
+			}
+			sc.skipLine();
+		}
+	});
+
+	// slot order depends on thread timing, sort to make the result deterministic
+	parallelFor(threads, [&](unsigned int t) {
+		uint32_t from = (uint64_t)csr.numNodes * t / threads;
+		uint32_t to = (uint64_t)csr.numNodes * (t + 1) / threads;
+		for (uint32_t i = from; i < to; ++i) {
+			std::sort(csr.outTargetsStore.begin() + csr.outOffsetsStore[i],
+					csr.outTargetsStore.begin() + csr.outOffsetsStore[i + 1]);
+			std::sort(csr.inSourcesStore.begin() + csr.inOffsetsStore[i],
+					csr.inSourcesStore.begin() + csr.inOffsetsStore[i + 1]);
+		}
+	});
+	csr.useStore();
+}
+
+void readInstanceCSR(const InputBuffer& buf, InstanceCSR& csr, unsigned int threads) {
+	if (isBinaryInstance(buf)) {
+		loadInstanceBinary(buf, csr);
+	} else {
+		parseInstanceCSR(buf, csr, threads);
+	}
+}
+
+uint64_t BinaryInstanceHeader::computeHeaderChecksum() const {
+	uint64_t words[(offsetof(BinaryInstanceHeader, headerChecksum)) / sizeof(uint64_t)];
+	std::memcpy(words, this, sizeof(words));
+	uint64_t hash = FNV1a_64_SEED;
+	for (auto w : words) {
+		FNV1a_64_update(hash, w);
+	}
+	return hash;
+}
+
+static uint64_t payloadChecksum(const InstanceCSR& csr) {
+	uint64_t hash = FNV1a_64_SEED;
+	for (auto v : csr.outOffsets) {
+		FNV1a_64_update(hash, v);
+	}
+	for (auto v : csr.inOffsets) {
+		FNV1a_64_update(hash, v);
+	}
+	for (auto v : csr.outTargets) {
+		FNV1a_64_update(hash, v);
+	}
+	for (auto v : csr.inSources) {
+		FNV1a_64_update(hash, v);
+	}
+	return hash;
+}
+
+static bool validOffsets(const ArrayView<uint64_t>& offsets, uint64_t arcs) {
+	if (offsets[0] != 0 || offsets[offsets.size - 1] != arcs) {
+		return false;
+	}
+	for (size_t i = 1; i < offsets.size; ++i) {
+		if (offsets[i] < offsets[i - 1]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool validNodeIDs(const ArrayView<uint32_t>& ids, uint32_t numNodes) {
+	uint32_t bad = 0;
+	for (auto x : ids) {
+		bad |= x == 0 || x > numNodes;
+	}
+	return bad == 0;
+}
+
+bool isBinaryInstance(const InputBuffer& buf) {
+	const auto& magic = BinaryInstanceHeader::MAGIC;
+	return buf.size() >= sizeof(BinaryInstanceHeader)
+			&& std::memcmp(buf.begin(), magic, sizeof(magic)) == 0;
+}
+
+void loadInstanceBinary(const InputBuffer& buf, InstanceCSR& csr, bool verifyPayload) {
+	if (!isBinaryInstance(buf)) {
+		csrInputError("not a binary instance");
+	}
+	BinaryInstanceHeader header;
+	std::memcpy(&header, buf.begin(), sizeof(header));
+	if (header.version != BinaryInstanceHeader::VERSION) {
+		csrInputError("unsupported binary instance version " + std::to_string(header.version));
+	}
+	if (header.headerChecksum != header.computeHeaderChecksum()) {
+		csrInputError("binary instance header checksum mismatch");
+	}
+	if (buf.size() != sizeof(header) + header.payloadSize()) {
+		csrInputError("binary instance has wrong size");
+	}
+	if (header.type == BinaryInstanceHeader::TYPE_DS) {
+		csr.type = "ds";
+	} else if (header.type == BinaryInstanceHeader::TYPE_HS) {
+		csr.type = "hs";
+	} else {
+		csrInputError("unknown binary instance type " + std::to_string(header.type));
+	}
+	if (header.numNodes != (csr.type == "hs" ? (uint64_t)header.n + header.m : header.n)
+			|| (csr.type == "ds" && header.numArcs != header.m)) {
+		csrInputError("binary instance header has inconsistent sizes");
+	}
+	csr.n = header.n;
+	csr.m = header.m;
+	csr.numNodes = header.numNodes;
+
+	const char* p = buf.begin() + sizeof(header);
+	csr.outOffsets = {reinterpret_cast<const uint64_t*>(p), (size_t)header.numNodes + 1};
+	p += csr.outOffsets.size * sizeof(uint64_t);
+	csr.inOffsets = {reinterpret_cast<const uint64_t*>(p), (size_t)header.numNodes + 1};
+	p += csr.inOffsets.size * sizeof(uint64_t);
+	csr.outTargets = {reinterpret_cast<const uint32_t*>(p), header.numArcs};
+	p += csr.outTargets.size * sizeof(uint32_t);
+	csr.inSources = {reinterpret_cast<const uint32_t*>(p), header.numArcs};
+
+	// the graph is built from the views without further checks, so always validate the structure,
+	// this is a cheap linear pass compared to the checksum
+	if (!validOffsets(csr.outOffsets, header.numArcs)
+			|| !validOffsets(csr.inOffsets, header.numArcs)) {
+		csrInputError("binary instance offsets are not monotone or do not match the arcs");
+	}
+	if (!validNodeIDs(csr.outTargets, header.numNodes)
+			|| !validNodeIDs(csr.inSources, header.numNodes)) {
+		csrInputError("binary instance contains invalid node IDs");
+	}
+	if (verifyPayload && payloadChecksum(csr) != header.payloadChecksum) {
+		csrInputError("binary instance payload checksum mismatch");
+	}
+}
+
+void loadInstanceBinary(InputBuffer&& buf, InstanceCSR& csr, bool verifyPayload) {
+	csr.mapping = std::move(buf);
+	loadInstanceBinary(csr.mapping, csr, verifyPayload);
+}
+
+template<typename T>
+static void writeArray(std::ostream& os, const ArrayView<T>& arr) {
+	os.write(reinterpret_cast<const char*>(arr.data), arr.size * sizeof(T));
+}
+
+bool writeInstanceBinary(const InstanceCSR& csr, std::ostream& os) {
+	BinaryInstanceHeader header {};
+	std::memcpy(header.magic, BinaryInstanceHeader::MAGIC, sizeof(header.magic));
+	header.version = BinaryInstanceHeader::VERSION;
+	header.type = csr.type == "hs" ? BinaryInstanceHeader::TYPE_HS : BinaryInstanceHeader::TYPE_DS;
+	header.n = csr.n;
+	header.m = csr.m;
+	header.numNodes = csr.numNodes;
+	header.numArcs = csr.numArcs();
+	header.payloadChecksum = payloadChecksum(csr);
+	header.headerChecksum = header.computeHeaderChecksum();
+
+	os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	writeArray(os, csr.outOffsets);
+	writeArray(os, csr.inOffsets);
+	writeArray(os, csr.outTargets);
+	writeArray(os, csr.inSources);
+	return os.good();
+}
+
+bool writeInstanceText(const InstanceCSR& csr, std::ostream& os) {
+	os << "p " << csr.type << " " << csr.n << " " << csr.m << "\n";
+	if (csr.type == "hs") {
+		for (uint32_t h = csr.n + 1; h <= csr.numNodes; ++h) {
+			bool first = true;
+			for (auto u : csr.in(h)) {
+				os << (first ? "" : " ") << u;
+				first = false;
+			}
+			os << "\n";
+		}
+	} else {
+		for (uint32_t u = 1; u <= csr.numNodes; ++u) {
+			for (auto v : csr.out(u)) {
+				os << u << " " << v << "\n";
+			}
+		}
+	}
+	return os.good();
+}
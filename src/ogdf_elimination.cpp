@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <utility>
+
+#include "ogdf_elimination.hpp"
+
+EliminationDecomposition::EliminationDecomposition(std::vector<std::vector<int>> neighbours)
+	: adj(std::move(neighbours)) {
+	for (size_t v = 0; v < adj.size(); ++v) {
+		auto& n = adj[v];
+		std::sort(n.begin(), n.end());
+		n.erase(std::unique(n.begin(), n.end()), n.end());
+		n.erase(std::remove(n.begin(), n.end(), (int)v), n.end());
+	}
+}
+
+size_t EliminationDecomposition::lowerBound() const {
+	size_t n = adj.size(), maxdeg = 0;
+	std::vector<size_t> deg(n);
+	for (size_t v = 0; v < n; ++v) {
+		deg[v] = adj[v].size();
+		maxdeg = std::max(maxdeg, deg[v]);
+	}
+	// bucket queue with stale entries, the minimum degree drops by at most one per removal
+	std::vector<std::vector<int>> buckets(maxdeg + 1);
+	for (size_t v = 0; v < n; ++v) {
+		buckets[deg[v]].push_back(v);
+	}
+	std::vector<uint8_t> removed(n, 0);
+	size_t degeneracy = 0, d = 0;
+	for (size_t done = 0; done < n;) {
+		while (buckets[d].empty()) {
+			++d;
+		}
+		int v = buckets[d].back();
+		buckets[d].pop_back();
+		if (removed[v] || deg[v] != d) {
+			continue;
+		}
+		removed[v] = 1;
+		++done;
+		degeneracy = std::max(degeneracy, d);
+		for (int u : adj[v]) {
+			if (!removed[u]) {
+				buckets[--deg[u]].push_back(u);
+			}
+		}
+		if (d > 0) {
+			--d;
+		}
+	}
+	return degeneracy;
+}
+
+bool EliminationDecomposition::eliminate(Heuristic h, size_t maxBag, std::vector<int>& order,
+		std::vector<std::vector<int>>& elimBags) const {
+	constexpr size_t TOO_LARGE = std::numeric_limits<size_t>::max();
+	size_t n = adj.size();
+	std::vector<std::vector<int>> nbr = adj;
+	std::vector<uint8_t> eliminated(n, 0);
+	std::vector<int> local(n, NONE);
+	std::vector<uint64_t> rows;
+
+	// number of missing edges within the neighbourhood of v, which has less than 64 vertices, from
+	// the neighbourhoods restricted to it as bitsets
+	auto fill = [&](int v) {
+		const auto& N = nbr[v];
+		for (size_t i = 0; i < N.size(); ++i) {
+			local[N[i]] = i;
+		}
+		rows.assign(N.size(), 0);
+		for (size_t i = 0; i < N.size(); ++i) {
+			for (int w : nbr[N[i]]) {
+				if (local[w] != NONE) {
+					rows[i] |= 1ull << local[w];
+				}
+			}
+		}
+		size_t missing = 0;
+		for (size_t i = 0; i < N.size(); ++i) {
+			uint64_t later = ((1ull << N.size()) - 1) & ~((2ull << i) - 1);
+			missing += __builtin_popcountll(later & ~rows[i]);
+		}
+		for (int u : N) {
+			local[u] = NONE;
+		}
+		return missing;
+	};
+
+	// vertices whose bag would be too large are taken last, at which point the elimination fails
+	using Key = std::pair<size_t, size_t>;
+	auto computeKey = [&](int v) -> Key {
+		size_t deg = nbr[v].size();
+		if (deg + 1 > maxBag) {
+			return {TOO_LARGE, deg};
+		}
+		return {h == Heuristic::MIN_FILL ? fill(v) : 0, deg};
+	};
+	using Entry = std::tuple<size_t, size_t, int>;
+	std::vector<Key> key(n);
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+	for (size_t v = 0; v < n; ++v) {
+		key[v] = computeKey(v);
+		queue.emplace(key[v].first, key[v].second, v);
+	}
+
+	order.clear();
+	elimBags.assign(n, {});
+	std::vector<int> mark(n, 0);
+	int stamp = 0;
+	while (!queue.empty()) {
+		auto [f, d, v] = queue.top();
+		queue.pop();
+		if (eliminated[v] || key[v] != Key(f, d)) {
+			continue;
+		}
+		if (f == TOO_LARGE) {
+			return false;
+		}
+		eliminated[v] = 1;
+		order.push_back(v);
+		std::vector<int> N = std::move(nbr[v]);
+		nbr[v] = {};
+
+		// turn the neighbourhood into a clique
+		for (int u : N) {
+			auto& Nu = nbr[u];
+			Nu.erase(std::find(Nu.begin(), Nu.end(), v));
+			++stamp;
+			for (int w : Nu) {
+				mark[w] = stamp;
+			}
+			for (int w : N) {
+				if (w != u && mark[w] != stamp) {
+					Nu.push_back(w);
+				}
+			}
+		}
+		// only the keys of the neighbours are updated, so min-fill is approximate
+		for (int u : N) {
+			key[u] = computeKey(u);
+			queue.emplace(key[u].first, key[u].second, u);
+		}
+
+		N.push_back(v);
+		std::sort(N.begin(), N.end());
+		elimBags[v] = std::move(N);
+	}
+	return true;
+}
+
+int EliminationDecomposition::addBag(Type type, int vertex, const std::vector<int>& content,
+		int child1, int child2) {
+	int b = bags.size();
+	Bag bag;
+	bag.type = type;
+	bag.vertex = vertex;
+	bag.children[0] = child1;
+	bag.children[1] = child2;
+	bags.push_back(bag);
+	for (int c : {child1, child2}) {
+		if (c != NONE) {
+			bags[c].parent = b;
+		}
+	}
+	vertices.insert(vertices.end(), content.begin(), content.end());
+	begin.push_back(vertices.size());
+	width = std::max(width, content.size());
+	return b;
+}
+
+void EliminationDecomposition::build(const std::vector<int>& order,
+		const std::vector<std::vector<int>>& elimBags) {
+	size_t n = adj.size();
+	bags.clear();
+	begin.assign(1, 0);
+	vertices.clear();
+	width = 0;
+	root = NONE;
+
+	// the parent of a vertex in the elimination tree is its neighbour eliminated first
+	std::vector<int> pos(n);
+	for (size_t i = 0; i < order.size(); ++i) {
+		pos[order[i]] = i;
+	}
+	std::vector<std::vector<int>> children(n);
+	std::vector<int> roots;
+	for (int v : order) {
+		int parent = NONE;
+		for (int u : elimBags[v]) {
+			if (u != v && (parent == NONE || pos[u] < pos[parent])) {
+				parent = u;
+			}
+		}
+		(parent == NONE ? roots : children[parent]).push_back(v);
+	}
+
+	// from bag b with content `from` to a bag with content `to`, forgetting before introducing
+	std::vector<int> cur;
+	auto transition = [&](int b, const std::vector<int>& from, const std::vector<int>& to) {
+		cur = from;
+		for (int x : from) {
+			if (!std::binary_search(to.begin(), to.end(), x)) {
+				cur.erase(std::lower_bound(cur.begin(), cur.end(), x));
+				b = addBag(Type::FORGET, x, cur, b, NONE);
+			}
+		}
+		for (int x : to) {
+			if (!std::binary_search(from.begin(), from.end(), x)) {
+				cur.insert(std::lower_bound(cur.begin(), cur.end(), x), x);
+				b = addBag(Type::INTRODUCE, x, cur, b, NONE);
+			}
+		}
+		return b;
+	};
+
+	std::vector<int> top(n, NONE), tops;
+	for (int v : order) {
+		const auto& bag = elimBags[v];
+		tops.clear();
+		if (children[v].empty()) {
+			cur = {bag[0]};
+			int b = addBag(Type::LEAF, bag[0], cur, NONE, NONE);
+			for (size_t i = 1; i < bag.size(); ++i) {
+				cur.push_back(bag[i]);
+				b = addBag(Type::INTRODUCE, bag[i], cur, b, NONE);
+			}
+			tops.push_back(b);
+		}
+		for (int c : children[v]) {
+			tops.push_back(transition(top[c], elimBags[c], bag));
+		}
+		int b = tops[0];
+		for (size_t i = 1; i < tops.size(); ++i) {
+			b = addBag(Type::JOIN, NONE, bag, b, tops[i]);
+		}
+		top[v] = b;
+	}
+
+	// the trees of several components are joined with empty bags
+	if (roots.size() == 1) {
+		root = top[roots[0]];
+		return;
+	}
+	for (int r : roots) {
+		int b = transition(top[r], elimBags[r], {});
+		root = root == NONE ? b : addBag(Type::JOIN, NONE, {}, root, b);
+	}
+}
+
+bool EliminationDecomposition::compute(Heuristic h, size_t maxBag) {
+	if (maxBag > 64) {
+		maxBag = 64;
+	}
+	std::vector<int> order;
+	std::vector<std::vector<int>> elimBags;
+	if (!eliminate(h, maxBag, order, elimBags)) {
+		return false;
+	}
+	build(order, elimBags);
+	return true;
+}
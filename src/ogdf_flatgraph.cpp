@@ -0,0 +1,482 @@
+#include <algorithm>
+
+#include "ogdf_flatgraph.hpp"
+#include "ogdf_parallel.hpp"
+#include "ogdf_stats.hpp"
+#include "ogdf_util.hpp"
+
+void FlatGraph::init(const InstanceCSR& csr, bool symmetric) {
+	uint32_t n = csr.numNodes;
+	outSeg_.assign(n, Segment());
+	inSeg_.assign(n, Segment());
+	deleted_.assign(n, 0);
+	liveNodes_ = n;
+	deadSlots_ = 0;
+
+	// every input edge {u,v} of a ds instance yields the arcs u->v and v->u
+	uint64_t pos = 0;
+	for (node v = 0; v < n; ++v) {
+		auto deg = csr.outdeg(v + 1) + (symmetric ? csr.indeg(v + 1) : 0);
+		outSeg_[v].begin = pos;
+		outSeg_[v].size = outSeg_[v].cap = outSeg_[v].live = deg;
+		pos += deg;
+	}
+	out_.resize(pos);
+	liveArcs_ = pos;
+	pos = 0;
+	for (node v = 0; v < n; ++v) {
+		auto deg = csr.indeg(v + 1) + (symmetric ? csr.outdeg(v + 1) : 0);
+		inSeg_[v].begin = pos;
+		inSeg_[v].size = inSeg_[v].cap = inSeg_[v].live = deg;
+		pos += deg;
+	}
+	in_.resize(pos);
+
+	reverse_.assign(out_.size(), NO_ARC);
+
+	// both arcs of an edge are created together, so that they can be paired
+	std::vector<uint64_t> outCursor(n), inCursor(n);
+	for (node v = 0; v < n; ++v) {
+		outCursor[v] = outSeg_[v].begin;
+		inCursor[v] = inSeg_[v].begin;
+	}
+	auto add = [&](node u, node v) {
+		uint64_t a = outCursor[u]++;
+		uint64_t i = inCursor[v]++;
+		out_[a] = {v, ARC_LIVE, i};
+		in_[i] = {u, ARC_LIVE, a};
+		return a;
+	};
+	for (node u = 0; u < n; ++u) {
+		for (auto v : csr.out(u + 1)) {
+			arc a = add(u, v - 1);
+			if (symmetric) {
+				arc b = add(v - 1, u);
+				reverse_[a] = b;
+				reverse_[b] = a;
+			}
+		}
+	}
+}
+
+void FlatGraph::append(std::vector<Entry>& arr, std::vector<Entry>& other, Segment& seg, Entry e) {
+	if (seg.size == seg.cap) {
+		// move the segment to the end of the array, dropping its tombstones
+		uint32_t cap = std::max(4u, (seg.live + seg.hidden) * 2);
+		uint64_t begin = arr.size();
+		bool isOut = &arr == &out_;
+		arr.resize(begin + cap);
+		if (isOut) {
+			reverse_.resize(arr.size(), NO_ARC);
+		}
+		uint64_t j = begin;
+		for (uint64_t i = seg.begin; i < seg.begin + seg.size; ++i) {
+			if (arr[i].state != ARC_DELETED) {
+				arr[j] = arr[i];
+				other[arr[j].twin].twin = j;
+				if (isOut && reverse_[i] != NO_ARC) {
+					reverse_[j] = reverse_[i];
+					reverse_[reverse_[j]] = j;
+					reverse_[i] = NO_ARC;
+				}
+				++j;
+			}
+		}
+		deadSlots_ += seg.cap - (seg.size - seg.live - seg.hidden);
+		seg.begin = begin;
+		seg.size = j - begin;
+		seg.cap = cap;
+	}
+	arr[seg.begin + seg.size] = e;
+	++seg.size;
+	++seg.live;
+}
+
+FlatGraph::node FlatGraph::addNode() {
+	outSeg_.emplace_back();
+	inSeg_.emplace_back();
+	deleted_.push_back(0);
+	++liveNodes_;
+	return deleted_.size() - 1;
+}
+
+FlatGraph::arc FlatGraph::addArc(node u, node v) {
+	OGDF_ASSERT(!deleted_[u] && !deleted_[v]);
+	append(out_, in_, outSeg_[u], {v, ARC_LIVE, 0});
+	arc a = outSeg_[u].begin + outSeg_[u].size - 1;
+	reverse_[a] = NO_ARC;
+	append(in_, out_, inSeg_[v], {u, ARC_LIVE, a});
+	out_[a].twin = inSeg_[v].begin + inSeg_[v].size - 1;
+	++liveArcs_;
+	return a;
+}
+
+void FlatGraph::pairArcs(arc a, arc b) {
+	OGDF_ASSERT(out_[a].state == ARC_LIVE && out_[b].state == ARC_LIVE);
+	OGDF_ASSERT(source(a) == target(b) && target(a) == source(b));
+	unpair(a);
+	unpair(b);
+	reverse_[a] = b;
+	reverse_[b] = a;
+}
+
+void FlatGraph::release(uint64_t a, bool hidden) {
+	unpair(a);
+	auto& os = outSeg_[source(a)];
+	auto& is = inSeg_[target(a)];
+	if (hidden) {
+		--os.hidden;
+		--is.hidden;
+	} else {
+		--os.live;
+		--is.live;
+		--liveArcs_;
+	}
+}
+
+void FlatGraph::deleteArc(arc a) {
+	auto state = out_[a].state;
+	if (state == ARC_DELETED) {
+		return;
+	}
+	release(a, state == ARC_HIDDEN);
+	out_[a].state = ARC_DELETED;
+	in_[out_[a].twin].state = ARC_DELETED;
+	deadSlots_ += 2;
+}
+
+void FlatGraph::hideArc(arc a) {
+	if (out_[a].state != ARC_LIVE) {
+		return;
+	}
+	release(a, false);
+	++outSeg_[source(a)].hidden;
+	++inSeg_[target(a)].hidden;
+	out_[a].state = ARC_HIDDEN;
+	in_[out_[a].twin].state = ARC_HIDDEN;
+}
+
+void FlatGraph::restoreArc(arc a) {
+	if (out_[a].state != ARC_HIDDEN) {
+		return;
+	}
+	release(a, true);
+	++outSeg_[source(a)].live;
+	++inSeg_[target(a)].live;
+	++liveArcs_;
+	out_[a].state = ARC_LIVE;
+	in_[out_[a].twin].state = ARC_LIVE;
+}
+
+void FlatGraph::deleteNode(node v) {
+	OGDF_ASSERT(!deleted_[v]);
+	const auto& os = outSeg_[v];
+	for (uint64_t a = os.begin; a < os.begin + os.size; ++a) {
+		deleteArc(a);
+	}
+	const auto& is = inSeg_[v];
+	for (uint64_t i = is.begin; i < is.begin + is.size; ++i) {
+		deleteArc(in_[i].twin);
+	}
+	deleted_[v] = 1;
+	--liveNodes_;
+}
+
+bool FlatGraph::compact(double maxDeadFraction) {
+	if (deadSlots_ <= maxDeadFraction * (out_.size() + in_.size())) {
+		return false;
+	}
+	std::vector<Entry> out, in;
+	std::vector<arc> reverse;
+	out.reserve(out_.size() + in_.size() - deadSlots_);
+	reverse.reserve(out.capacity());
+	for (node v = 0; v < nodeSlots(); ++v) {
+		auto& seg = outSeg_[v];
+		uint64_t begin = out.size();
+		for (uint64_t a = seg.begin; !deleted_[v] && a < seg.begin + seg.size; ++a) {
+			if (out_[a].state != ARC_DELETED) {
+				// temporarily point the twin to the new position
+				in_[out_[a].twin].twin = out.size();
+				out.push_back(out_[a]);
+				reverse.push_back(reverse_[a]);
+			}
+		}
+		seg.begin = begin;
+		seg.size = seg.cap = out.size() - begin;
+	}
+	// paired arcs are live, so the twin of the reverse already holds its new position
+	for (auto& r : reverse) {
+		if (r != NO_ARC) {
+			r = in_[out_[r].twin].twin;
+		}
+	}
+	out_.swap(out);
+	reverse_.swap(reverse);
+	reverse.clear();
+	reverse.shrink_to_fit();
+	out_.shrink_to_fit();
+	out.clear();
+	out.shrink_to_fit();
+
+	in.reserve(out_.size());
+	for (node v = 0; v < nodeSlots(); ++v) {
+		auto& seg = inSeg_[v];
+		uint64_t begin = in.size();
+		for (uint64_t i = seg.begin; !deleted_[v] && i < seg.begin + seg.size; ++i) {
+			if (in_[i].state != ARC_DELETED) {
+				out_[in_[i].twin].twin = in.size();
+				in.push_back(in_[i]);
+			}
+		}
+		seg.begin = begin;
+		seg.size = seg.cap = in.size() - begin;
+	}
+	in_.swap(in);
+	deadSlots_ = 0;
+	return true;
+}
+
+void FlatInstance::read(const InputBuffer& buf) {
+	InstanceCSR csr;
+	readInstanceCSR(buf, csr, paceThreads());
+	initFromCSR(csr);
+}
+
+void FlatInstance::initFromCSR(const InstanceCSR& csr) {
+	bool hs = csr.type == "hs";
+	type = csr.type;
+	G.init(csr, !hs);
+	node2ID.resize(csr.numNodes);
+	is_dominated.assign(csr.numNodes, 0);
+	is_subsumed.assign(csr.numNodes, 0);
+	is_hidden_loop.assign(csr.numNodes, 0);
+	for (node v = 0; v < csr.numNodes; ++v) {
+		node2ID[v] = v + 1;
+		if (hs) {
+			if (v < csr.n) {
+				is_dominated[v] = 1;
+			} else {
+				is_subsumed[v] = 1;
+			}
+		}
+	}
+	maxid = csr.numNodes;
+}
+
+FlatInstance::node FlatInstance::addNode() {
+	node v = G.addNode();
+	node2ID.push_back(++maxid);
+	is_dominated.push_back(0);
+	is_subsumed.push_back(0);
+	is_hidden_loop.push_back(0);
+	return v;
+}
+
+void FlatInstance::addToDominatingSet(node v) {
+	OGDF_ASSERT(!is_subsumed[v]);
+	DS.push_back(node2ID[v]);
+	G.forAllOut(v, [&](FlatGraph::arc, node w) {
+		markDominated(w);
+		return true;
+	});
+	G.forAllHidden(v, [&](FlatGraph::arc a, bool isSource) {
+		if (isSource) { // now that the successors are really dominated, they cannot have hidden incoming edges anymore!
+			markDominated(G.target(a));
+		}
+	});
+	safeDelete(v);
+}
+
+void FlatInstance::markDominated(node v, bool byreduction) {
+	is_hidden_loop[v] = !is_dominated[v] && !is_subsumed[v] && byreduction;
+	is_dominated[v] = 1;
+	G.forAllIn(v, [&](FlatGraph::arc a, node) {
+		if (byreduction) {
+			G.hideArc(a);
+		} else {
+			G.deleteArc(a);
+		}
+		return true;
+	});
+	if (!byreduction) {
+		// v is really dominated, so we need to remove incoming hidden edges
+		removeHiddenIncomingEdges(v);
+	}
+}
+
+void FlatInstance::markSubsumed(node v) {
+	is_hidden_loop[v] = 0;
+	is_subsumed[v] = 1;
+	G.forAllOut(v, [&](FlatGraph::arc a, node) {
+		G.deleteArc(a);
+		return true;
+	});
+	removeHiddenOutgoingEdges(v);
+}
+
+void FlatInstance::removeHiddenIncomingEdges(node v) {
+	is_hidden_loop[v] = 0;
+	G.forAllHidden(v, [&](FlatGraph::arc a, bool isSource) {
+		if (!isSource) {
+			G.deleteArc(a);
+		}
+	});
+}
+
+void FlatInstance::removeHiddenOutgoingEdges(node v) {
+	is_hidden_loop[v] = 0;
+	G.forAllHidden(v, [&](FlatGraph::arc a, bool isSource) {
+		if (isSource) {
+			G.deleteArc(a);
+		}
+	});
+}
+
+static FlatGraph::node firstOut(const FlatGraph& G, FlatGraph::node v) {
+	FlatGraph::node ret = -1;
+	G.forAllOut(v, [&](FlatGraph::arc, FlatGraph::node w) {
+		ret = w;
+		return false;
+	});
+	return ret;
+}
+
+static FlatGraph::node firstIn(const FlatGraph& G, FlatGraph::node v) {
+	FlatGraph::node ret = -1;
+	G.forAllIn(v, [&](FlatGraph::arc, FlatGraph::node w) {
+		ret = w;
+		return false;
+	});
+	return ret;
+}
+
+// same rules as Instance::reductionExtremeDegrees
+bool FlatInstance::reductionExtremeDegrees() {
+	int orig_N = G.numberOfNodes(), orig_DS = DS.size();
+	bool reduced = false;
+	for (node n = 0; n < G.nodeSlots(); ++n) {
+		if (G.isDeleted(n)) {
+			continue;
+		}
+
+		// isolated
+		if (G.indeg(n) == 0 && !is_dominated[n]) {
+			addToDominatingSet(n);
+			reduced = true;
+			continue;
+		}
+		if (G.outdeg(n) == 0 && is_dominated[n]) {
+			safeDelete(n);
+			reduced = true;
+			continue;
+		}
+
+		// antenna
+		if (G.indeg(n) == 1
+				&& (G.outdeg(n) == 0
+						|| (G.outdeg(n) == 1 && firstOut(G, n) == firstIn(G, n)))) {
+			auto u = firstIn(G, n);
+			OGDF_ASSERT(u != n);
+			addToDominatingSet(u);
+			reduced = true;
+			continue;
+		}
+		if (G.outdeg(n) == 1 && is_dominated[n]) {
+			auto u = firstOut(G, n);
+			if (!is_subsumed[u] || G.indeg(u) >= 2) {
+				safeDelete(n);
+			} else {
+				addToDominatingSet(n);
+			}
+			reduced = true;
+			continue;
+		}
+	}
+	if (reduced) {
+		log << "Simple reduction removed " << (orig_N - (int)G.numberOfNodes())
+			<< " vertices, added " << (DS.size() - orig_DS) << " to DS." << std::endl;
+	}
+	return reduced;
+}
+
+// same rule as Instance::reductionContraction
+bool FlatInstance::reductionContraction() {
+	size_t cnt_removed = 0;
+	std::vector<node> in_neighbors;
+	std::vector<FlatGraph::arc> out_arc;
+	for (node u = 0; u < G.nodeSlots(); ++u) {
+		if (G.isDeleted(u) || !is_dominated[u] || is_subsumed[u]) {
+			continue;
+		}
+		node takev = -1;
+		G.forAllOut(u, [&](FlatGraph::arc, node v) {
+			if (!is_dominated[v] && is_subsumed[v]) {
+				takev = v;
+				return false;
+			}
+			return true;
+		});
+		if (takev == (node)-1) {
+			continue;
+		}
+		in_neighbors.clear();
+		G.forAllIn(takev, [&](FlatGraph::arc, node w) {
+			if (w != u) {
+				in_neighbors.push_back(w);
+			}
+			return true;
+		});
+		// the new arc w->u is the reverse of an existing unpaired u->w, as in Instance
+		if (out_arc.size() < G.nodeSlots()) {
+			out_arc.resize(G.nodeSlots(), FlatGraph::NO_ARC);
+		}
+		G.forAllOut(u, [&](FlatGraph::arc a, node w) {
+			if (G.reverse(a) == FlatGraph::NO_ARC) {
+				out_arc[w] = a;
+			}
+			return true;
+		});
+		for (auto w : in_neighbors) {
+			auto a = G.addArc(w, u);
+			if (out_arc[w] != FlatGraph::NO_ARC) {
+				G.pairArcs(a, out_arc[w]);
+				out_arc[w] = FlatGraph::NO_ARC;
+			}
+		}
+		G.forAllOut(u, [&](FlatGraph::arc, node w) {
+			out_arc[w] = FlatGraph::NO_ARC;
+			return true;
+		});
+		safeDelete(takev);
+		cnt_removed++;
+		is_dominated[u] = 0;
+		removeHiddenIncomingEdges(u);
+	}
+	if (cnt_removed > 0) {
+		log << "Contraction removed " << cnt_removed << " vertices" << std::endl;
+	}
+	return cnt_removed > 0;
+}
+
+template<typename F>
+static bool runFlatRule(const char* rule, FlatInstance& I, F&& f) {
+	ScopedRuleTimer<FlatInstance> timer(rule, 0, I);
+	return timer(f());
+}
+
+void FlatInstance::reduce() {
+	bool changed = true;
+	for (int i = 0; changed; ++i) {
+		log << "Flat reduce iteration " << i << ": " << G.numberOfNodes() << " nodes, "
+			<< G.numberOfEdges() << " edges, " << (G.memoryUsage() >> 20) << " MB" << std::endl;
+		changed = false;
+		while (runFlatRule(
+				"flat_extreme_degrees", *this, [&] { return reductionExtremeDegrees(); })) {
+			changed = true;
+		}
+		if (runFlatRule("flat_contraction", *this, [&] { return reductionContraction(); })) {
+			changed = true;
+		}
+		G.compact();
+	}
+}
@@ -119,21 +119,22 @@ void Instance::dumpBCTree() {
 bool Instance::reductionExtremeDegrees() {
 	int orig_N = G.numberOfNodes(), orig_DS = DS.size();
 	bool reduced = false;
-	int i = G.numberOfNodes();
-	for (auto it = G.nodes.begin(); it != G.nodes.end(); --i) {
-		OGDF_ASSERT(i >= 0); // protect against endless loops
-		auto n = *it;
+	seedWorklists();
+	// whether a rule applies only depends on the degrees and flags of n itself,
+	// so the touched vertices are exactly the ones that need to be rechecked
+	while (dirty_degrees.size() > 0) {
+		auto n = *dirty_degrees.begin();
+		dirty_degrees.remove(n);
 		OGDF_ASSERT(checkNode(n));
-		++it; // increment now so that we can safely delete n
 
 		// isolated
 		if (n->indeg() == 0 && !is_dominated[n]) {
-			addToDominatingSet(n, it);
+			addToDominatingSet(n);
 			reduced = true;
 			continue;
 		}
 		if (n->outdeg() == 0 && is_dominated[n]) {
-			safeDelete(n, it);
+			safeDelete(n);
 			reduced = true;
 			continue;
 		}
@@ -146,7 +147,7 @@ bool Instance::reductionExtremeDegrees() {
 										== n->adjEntries.tail()->twinNode()))) {
 			auto u = n->adjEntries.head()->twinNode();
 			OGDF_ASSERT(u != n);
-			addToDominatingSet(u, it);
+			addToDominatingSet(u);
 			reduced = true;
 			continue;
 		}
@@ -154,9 +155,9 @@ bool Instance::reductionExtremeDegrees() {
 			OGDF_ASSERT(n->adjEntries.head()->isSource());
 			auto u = n->adjEntries.head()->twinNode();
 			if (!is_subsumed[u] || u->indeg() >= 2) {
-				safeDelete(n, it);
+				safeDelete(n);
 			} else {
-				addToDominatingSet(n, it);
+				addToDominatingSet(n);
 			}
 			reduced = true;
 			continue;
@@ -189,14 +190,9 @@ std::list<Instance> Instance::decomposeConnectedComponents() {
 	return instances;
 }
 
-static int max_BC_changes = -1;
-
 bool Instance::reductionBCTree(int depth) {
 	enum class Replaced { Unchanged, MarkDominated, AddToDS };
 
-	if (max_BC_changes == 0) {
-		return false;
-	}
 	int orig_N = G.numberOfNodes(), orig_DS = DS.size();
 	ogdf::BCTree BC(G);
 	ogdf::NodeArray<Replaced> replaced(BC.bcTree(), Replaced::Unchanged);
@@ -299,36 +295,69 @@ bool Instance::reductionBCTree(int depth) {
 				en_case_2A = false;
 			}
 
-#define LAZY_INSTANCE(INST, COM, INIT, D)                                                          \
-	std::unique_ptr<Instance> INST;                                                                \
-	auto get_##INST = [&]() -> Instance& {                                                         \
-		if (INST) {                                                                                \
-			return *INST;                                                                          \
-		}                                                                                          \
-		log << COM << std::endl;                                                                   \
-		INST = std::make_unique<Instance>();                                                       \
-		nMap.fillWithDefault();                                                                    \
-		eMap.fillWithDefault();                                                                    \
-		INST->G.insert(nodes, BC.hEdges(node), nMap, eMap);                                        \
-		INST->initFrom(*this, nodes, BC.hEdges(node), nMap, eMap, original_n, original_e, copy_e); \
-		ogdf::Logger::Indent _(logger);                                                            \
-		INIT;                                                                                      \
-		reduceAndSolve(*INST, depth * 100 + D);                                                    \
-		return *INST;                                                                              \
+			auto copy_block = [&](Instance& inst) {
+				nMap.fillWithDefault();
+				eMap.fillWithDefault();
+				inst.G.insert(nodes, BC.hEdges(node), nMap, eMap);
+				inst.initFrom(
+						*this, nodes, BC.hEdges(node), nMap, eMap, original_n, original_e, copy_e);
+			};
+
+			// Small blocks are not copied and reduced once per case, but encoded once into an
+			// incremental MaxSAT solver that answers all cases under assumptions. This is only done
+			// if solveExact would use UWrMaxSat, otherwise and if a case is cancelled the block is
+			// copied and solved as usual.
+#ifdef USE_UWRMAXSAT
+			bool incremental = nodes.size() <= SMALL_BLOCK && exactBackendSelected("uwrmaxsat");
+			std::unique_ptr<Instance> block;
+			std::unique_ptr<CutVertexSolver> block_solver;
+			Cancellation cancel;
+#else
+			bool incremental = false;
+#endif
+			auto solve_incrementally = [&](CutVertexCase c, DominatingSet& DS) {
+#ifdef USE_UWRMAXSAT
+				if (!block_solver) {
+					block = std::make_unique<Instance>();
+					copy_block(*block);
+					block_solver = std::make_unique<CutVertexSolver>(*block, nMap[h_cv]);
+				}
+				return block_solver->solve(c, DS, cancel);
+#else
+				return false;
+#endif
+			};
+
+#define LAZY_INSTANCE(INST, COM, INIT, D, CASE)                                  \
+	std::unique_ptr<Instance> INST;                                              \
+	auto get_##INST = [&]() -> Instance& {                                       \
+		if (INST) {                                                              \
+			return *INST;                                                        \
+		}                                                                        \
+		log << COM << std::endl;                                                 \
+		INST = std::make_unique<Instance>();                                     \
+		ogdf::Logger::Indent _(logger);                                          \
+		if (incremental && solve_incrementally(CutVertexCase::CASE, INST->DS)) { \
+			return *INST;                                                        \
+		}                                                                        \
+		copy_block(*INST);                                                       \
+		INIT;                                                                    \
+		reduceAndSolve(*INST, depth * 100 + D);                                  \
+		return *INST;                                                            \
 	};
 
 			LAZY_INSTANCE(I1, "I1: Computing ds(X_B - v) with cut-vertex v already dominated.",
-					I1->markDominated(nMap[h_cv]), 10);
-			LAZY_INSTANCE(I2, "I2: Computing normal ds(X_B).", , 20);
+					I1->markDominated(nMap[h_cv]), 10, DOMINATED);
+			LAZY_INSTANCE(I2, "I2: Computing normal ds(X_B).", , 20, FREE);
 			LAZY_INSTANCE(I3, "I3: Computing ds(X_B) containing v.",
-					I3->addToDominatingSet(nMap[h_cv]), 30);
+					I3->addToDominatingSet(nMap[h_cv]), 30, IN_DS);
 			auto smaller_DS_no_CV = [&] { return get_I1().DS.size() < get_I2().DS.size(); };
-			std::unordered_set<int>* opt_DS_with_CV = nullptr;
+			DominatingSet* opt_DS_with_CV = nullptr;
 			auto opt_DS_has_CV = [&] {
 				if (opt_DS_with_CV) {
 					return true;
 				}
-				if (get_I2().DS.find(node2ID[cv]) != get_I2().DS.end()) {
+				if (get_I2().DS.contains(node2ID[cv])) {
 					log << "RR-BC Case 2A(sc): The ds(X_B) from I2 already contains v." << std::endl;
 					opt_DS_with_CV = &get_I2().DS;
 					return true;
@@ -345,7 +374,7 @@ bool Instance::reductionBCTree(int depth) {
 				log << "RR-BC Case 1: ds(X_B - v) < ds(X_B). Removing block, but leaving cut-vertex unchanged."
 					<< std::endl;
 				OGDF_ASSERT(get_I2().DS.size() - get_I1().DS.size() == 1);
-				addToDominatingSet(get_I1().DS.begin(), get_I1().DS.end(), "ds(X_B - v)");
+				addToDominatingSet(get_I1().DS, "ds(X_B - v)");
 			} else {
 				log << "RR-BC Case 2: ds(X_B - v) = ds(X_B). Looking for optimal ds(X_B) containing cut-vertex v..."
 					<< std::endl;
@@ -357,16 +386,14 @@ bool Instance::reductionBCTree(int depth) {
 					replaced[parent] = Replaced::AddToDS;
 					opt_DS_has_CV(); // ensure opt_DS_with_CV is set (this has no overhead in all cases)
 					OGDF_ASSERT(opt_DS_with_CV != nullptr);
-					addToDominatingSet(opt_DS_with_CV->begin(), opt_DS_with_CV->end(),
-							"ds(B_X) containing v");
+					addToDominatingSet(*opt_DS_with_CV, "ds(B_X) containing v");
 				} else {
 					OGDF_ASSERT(en_case_2B);
 					log << "RR-BC Case 2B: No optimal ds(X_B) contains v. "
 						<< "Marking v as dominated (by B) and removing block B." << std::endl;
 					OGDF_ASSERT(is_subsumed[cv] || get_I3().DS.size() - get_I2().DS.size() == 1);
 					replaced[parent] = Replaced::MarkDominated;
-					addToDominatingSet(get_I2().DS.begin(), get_I2().DS.end(),
-							"ds(B_X) not containing v");
+					addToDominatingSet(get_I2().DS, "ds(B_X) not containing v");
 				}
 			}
 
@@ -377,13 +404,6 @@ bool Instance::reductionBCTree(int depth) {
 					safeDelete(n);
 				}
 			}
-
-			if (max_BC_changes > 0) {
-				max_BC_changes--;
-			}
-			if (max_BC_changes == 0) {
-				break;
-			}
 		}
 	}
 	int d = 0, r = 0;
@@ -545,6 +565,7 @@ bool Instance::reductionStrongSubsumption() {
 							} else {
 								reverse_edge[e] = nullptr;
 							}
+							touch(adj->twinNode());
 						}
 						return true;
 					});
@@ -555,6 +576,7 @@ bool Instance::reductionStrongSubsumption() {
 				}
 				is_dominated[u] = is_dominated[u] && is_dominated[v];
 				is_subsumed[u] = is_subsumed[u] && is_subsumed[v];
+				touchFlags(u);
 				safeDelete(v, it);
 				cnt_removed++;
 			}
@@ -652,25 +674,12 @@ ogdf::NodeArray<u_int64_t> Instance::computeInadjMask() {
 }
 
 bool Instance::reductionNeighborhoodSubsets() {
-	SubsetRefine refineSubsume(*this, RefineType::Subsume);
-	refineSubsume.init();
-	size_t cntsubsumed = refineSubsume.doRefinementReduction();
-	SubsetRefine refineDominate(*this, RefineType::Dominate);
-	refineDominate.init();
-	size_t cntdominated = refineDominate.doRefinementReduction();
-	if (cntdominated + cntsubsumed > 0) {
-		log << "Dominated " << cntdominated << " nodes" << std::endl;
-		log << "Subsumed " << cntsubsumed << " nodes" << std::endl;
-		size_t cnt_removed = 0;
-		for (auto it = G.nodes.begin(); it != G.nodes.end();) {
-			auto v = *it;
-			it++;
-			if (is_subsumed[v] && is_dominated[v]) {
-				safeDelete(v, it);
-				cnt_removed++;
-			}
-		}
-		log << "Removed " << cnt_removed << " nodes" << std::endl;
+	SubsetRefine refine(*this);
+	refine.run();
+	if (refine.numberSubsumed() + refine.numberDominated() + refine.numberRemoved() > 0) {
+		log << "Dominated " << refine.numberDominated() << " nodes" << std::endl;
+		log << "Subsumed " << refine.numberSubsumed() << " nodes" << std::endl;
+		log << "Removed " << refine.numberRemoved() << " nodes" << std::endl;
 		return true;
 	}
 	return false;
@@ -678,56 +687,58 @@ bool Instance::reductionNeighborhoodSubsets() {
 
 bool Instance::reductionContraction() {
 	size_t cnt_removed = 0;
-	ogdf::NodeArray<ogdf::edge> theedge(G, nullptr);
-	for (auto it = G.nodes.begin(); it != G.nodes.end();) {
-		auto u = *it;
-		it++;
-
-		if (is_dominated[u] && !is_subsumed[u]) {
-			bool contracted = false;
-
-			forAllOutAdj(u, [&](ogdf::adjEntry adj) {
-				theedge[adj->twinNode()] = adj->theEdge();
-				return true;
-			});
+	seedWorklists();
+	std::unordered_map<ogdf::node, ogdf::edge> theedge;
+	std::vector<ogdf::node> in_neighbors;
+	// u can only become contractible if its flags or those of an out-neighbour change
+	while (dirty_contraction.size() > 0) {
+		auto u = *dirty_contraction.begin();
+		dirty_contraction.remove(u);
+		if (!is_dominated[u] || is_subsumed[u]) {
+			continue;
+		}
 
-			ogdf::node takev = nullptr;
-			forAllOutAdj(u, [&](ogdf::adjEntry adj) {
-				auto v = adj->twinNode();
-				if (!is_dominated[v] && is_subsumed[v]) {
-					takev = v;
-					return false;
-				}
-				return true;
-			});
-			if (takev != nullptr) {
-				std::list<ogdf::node> in_neighbors;
-				forAllInAdj(takev, [&](ogdf::adjEntry adj2) {
-					if (adj2->twinNode() != u) {
-						in_neighbors.push_back(adj2->twinNode());
-					}
-					return true;
-				});
-				for (auto w : in_neighbors) {
-					auto e = G.newEdge(w, ogdf::Direction::before, u, ogdf::Direction::after);
-					if (theedge[w] != nullptr) {
-						reverse_edge[e] = theedge[w];
-						reverse_edge[theedge[w]] = e;
-					} else {
-						reverse_edge[e] = nullptr;
-					}
-				}
-				safeDelete(takev, it);
-				cnt_removed++;
-				is_dominated[u] = false;
-				removeHiddenIncomingEdges(u);
+		ogdf::node takev = nullptr;
+		forAllOutAdj(u, [&](ogdf::adjEntry adj) {
+			auto v = adj->twinNode();
+			if (!is_dominated[v] && is_subsumed[v]) {
+				takev = v;
+				return false;
 			}
+			return true;
+		});
+		if (takev == nullptr) {
+			continue;
+		}
 
-			forAllOutAdj(u, [&](ogdf::adjEntry adj) {
-				theedge[adj->twinNode()] = nullptr;
-				return true;
-			});
+		theedge.clear();
+		forAllOutAdj(u, [&](ogdf::adjEntry adj) {
+			theedge[adj->twinNode()] = adj->theEdge();
+			return true;
+		});
+		in_neighbors.clear();
+		forAllInAdj(takev, [&](ogdf::adjEntry adj2) {
+			if (adj2->twinNode() != u) {
+				in_neighbors.push_back(adj2->twinNode());
+			}
+			return true;
+		});
+		for (auto w : in_neighbors) {
+			auto e = G.newEdge(w, ogdf::Direction::before, u, ogdf::Direction::after);
+			auto it = theedge.find(w);
+			if (it != theedge.end()) {
+				reverse_edge[e] = it->second;
+				reverse_edge[it->second] = e;
+			} else {
+				reverse_edge[e] = nullptr;
+			}
+			touch(w);
 		}
+		safeDelete(takev);
+		cnt_removed++;
+		is_dominated[u] = false;
+		touchFlags(u);
+		removeHiddenIncomingEdges(u);
 	}
 	if (cnt_removed > 0) {
 		log << "Contraction removed " << cnt_removed << " vertices" << std::endl;
@@ -875,6 +886,7 @@ bool Instance::reductionSpecial2(int d) {
 				for (auto q : Q) {
 					auto e = G.newEdge(qnode, ogdf::Direction::before, q, ogdf::Direction::after);
 					reverse_edge[e] = nullptr;
+					touch(q);
 				}
 				qids.push(qid);
 				Rvids.push(Rvid);
@@ -900,7 +912,7 @@ bool Instance::reductionSpecial2(int d) {
 			auto Rv2id = Rv2ids.top();
 			Rv2ids.pop();
 
-			if (DS.find(qid) != DS.end()) {
+			if (DS.contains(qid)) {
 				DS.insert(Rv1id);
 				DS.insert(Rv2id);
 				DS.erase(qid);
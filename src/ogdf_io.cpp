@@ -1,103 +1,117 @@
+#include "ogdf_csr.hpp"
 #include "ogdf_instance.hpp"
+#include "ogdf_parallel.hpp"
+
+[[noreturn]] static void inputError() {
+	std::cerr << "Error reading input" << std::endl;
+	std::exit(1);
+}
 
 void Instance::read(std::istream& is, std::vector<ogdf::node>& ID2node) {
-	unsigned int n, m;
-	std::string s;
-	std::string line;
-	while (line.empty() || line[0] == 'c') {
-		if (!is.good()) {
-			std::cerr << "Error reading input" << std::endl;
-			std::exit(1);
-		}
-		getline(is, line);
-	}
-	std::istringstream iss(line);
-	iss >> s;
-	if (s != "p") {
-		std::cerr
-				<< "Bad header line not matching `p (ds|hs) [0-9]+ [0-9]+`: " << line.substr(0, 100)
-				<< std::endl;
-		std::exit(1);
-	}
-	iss >> type;
-	iss >> n >> m;
-	if (type == "ds") {
-		read_DS(is, ID2node, n, m);
-	} else if (type == "hs") {
-		read_HS(is, ID2node, n, m);
-	} else {
-		std::cerr << "Unknown input type " << type << std::endl;
-		std::exit(1);
+	InputBuffer buf;
+	if (!buf.readStream(is)) {
+		inputError();
 	}
+	read(buf, ID2node);
+}
+
+// small inputs are parsed by a single thread anyway, so there is no separate sequential reader
+void Instance::read(const InputBuffer& buf, std::vector<ogdf::node>& ID2node) {
+	InstanceCSR csr;
+	readInstanceCSR(buf, csr, paceThreads());
+	initFromCSR(csr, ID2node);
 }
 
-void Instance::read_DS(std::istream& is, std::vector<ogdf::node>& ID2node, unsigned int n,
-		unsigned int m) {
-	std::string line;
+void Instance::initFromCSR(const InstanceCSR& csr, std::vector<ogdf::node>& ID2node) {
+	bool hs = csr.type == "hs";
+	type = csr.type;
 	clear();
 	ID2node.clear();
-	ID2node.reserve(n + 1);
+	ID2node.reserve(csr.numNodes + 1);
 	ID2node.push_back(nullptr);
-	for (int i = 1; i <= n; i++) {
-		auto n = G.newNode(i);
-		ID2node.push_back(n);
-		node2ID[n] = i;
+	for (uint32_t i = 1; i <= csr.numNodes; i++) {
+		auto node = G.newNode(i);
+		ID2node.push_back(node);
+		node2ID[node] = i;
+		if (hs) {
+			if (i <= csr.n) {
+				is_dominated[node] = true;
+			} else {
+				is_subsumed[node] = true;
+			}
+		}
 	}
-	maxid = n;
-	for (int i = 0; i < m; i++) {
-		line.clear();
-		while (line.empty() || line[0] == 'c') {
-			if (!is.good()) {
-				std::cerr << "Error reading input" << std::endl;
-				std::exit(1);
+	maxid = csr.numNodes;
+	DS.reserve(maxid);
+	for (uint32_t u = 1; u <= csr.numNodes; u++) {
+		auto nu = ID2node[u];
+		for (auto v : csr.out(u)) {
+			// sources front, targets tail
+			auto e = G.newEdge(nu, ogdf::Direction::before, ID2node[v], ogdf::Direction::after);
+			if (hs) {
+				reverse_edge[e] = nullptr;
+			} else {
+				auto f = G.newEdge(ID2node[v], ogdf::Direction::before, nu, ogdf::Direction::after);
+				reverse_edge[e] = f;
+				reverse_edge[f] = e;
 			}
-			getline(is, line);
 		}
-		int u, v;
-		std::istringstream iss(line);
-		iss >> u >> v;
-		// sources front, targets tail
-		auto e = G.newEdge(ID2node[u], ogdf::Direction::before, ID2node[v], ogdf::Direction::after);
-		auto f = G.newEdge(ID2node[v], ogdf::Direction::before, ID2node[u], ogdf::Direction::after);
-		reverse_edge[e] = f;
-		reverse_edge[f] = e;
 	}
-	OGDF_ASSERT(G.numberOfNodes() == n);
-	OGDF_ASSERT(G.numberOfEdges() == m * 2);
+	OGDF_ASSERT(G.numberOfEdges() == csr.numArcs() * (hs ? 1 : 2));
 }
 
-void Instance::read_HS(std::istream& is, std::vector<ogdf::node>& ID2node, unsigned int n,
-		unsigned int m) {
-	std::string line;
+void Instance::initFromFlat(const FlatInstance& F) {
+	const auto& FG = F.G;
+	type = F.type;
 	clear();
-	ID2node.clear();
-	ID2node.reserve(n + m + 1);
-	ID2node.push_back(nullptr);
-	for (int i = 1; i <= n + m; i++) {
-		auto node = G.newNode(i);
-		ID2node.push_back(node);
-		node2ID[node] = i;
-		if (i <= n) {
-			is_dominated[node] = true;
-		} else {
-			is_subsumed[node] = true;
+	std::vector<ogdf::node> flat2node(FG.nodeSlots(), nullptr);
+	for (FlatGraph::node v = 0; v < FG.nodeSlots(); ++v) {
+		if (FG.isDeleted(v)) {
+			continue;
 		}
+		auto node = G.newNode(F.node2ID[v]);
+		flat2node[v] = node;
+		node2ID[node] = F.node2ID[v];
+		is_dominated[node] = F.is_dominated[v];
+		is_subsumed[node] = F.is_subsumed[v];
+		is_hidden_loop[node] = F.is_hidden_loop[v];
 	}
-	for (int i = 0; i < m; i++) {
-		line.clear();
-		while (line.empty() || line[0] == 'c') {
-			if (!is.good()) {
-				std::cerr << "Error reading input" << std::endl;
-				std::exit(1);
-			}
-			getline(is, line);
+	maxid = F.maxid;
+	DS.reserve(maxid);
+	DS.insert(F.DS.begin(), F.DS.end());
+
+	std::vector<ogdf::edge> arc2edge(FG.arcSlots(), nullptr);
+	for (FlatGraph::node u = 0; u < FG.nodeSlots(); ++u) {
+		if (FG.isDeleted(u)) {
+			continue;
 		}
-		std::istringstream iss(line);
-		int u;
-		while (iss >> u) {
-			auto e = G.newEdge(ID2node[u], ogdf::Direction::before, ID2node[i + n + 1],
+		FG.forAllOut(u, [&](FlatGraph::arc a, FlatGraph::node v) {
+			// sources front, targets tail
+			arc2edge[a] = G.newEdge(flat2node[u], ogdf::Direction::before, flat2node[v],
 					ogdf::Direction::after);
-			reverse_edge[e] = nullptr;
+			return true;
+		});
+		FG.forAllHidden(u, [&](FlatGraph::arc a, bool isSource) {
+			if (isSource) {
+				hidden_edges.hide(G.newEdge(flat2node[u], flat2node[FG.target(a)]));
+			}
+		});
+	}
+
+	// pair up u->v and v->u as recorded by the flat graph
+	for (FlatGraph::node u = 0; u < FG.nodeSlots(); ++u) {
+		if (FG.isDeleted(u)) {
+			continue;
 		}
+		FG.forAllOut(u, [&](FlatGraph::arc a, FlatGraph::node) {
+			auto r = FG.reverse(a);
+			if (r != FlatGraph::NO_ARC) {
+				OGDF_ASSERT(FG.reverse(r) == a && arc2edge[r] != nullptr);
+				reverse_edge[arc2edge[a]] = arc2edge[r];
+			}
+			return true;
+		});
 	}
+	OGDF_ASSERT(G.numberOfNodes() == FG.numberOfNodes());
+	OGDF_ASSERT(G.numberOfEdges() == FG.numberOfEdges());
 }
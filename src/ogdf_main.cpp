@@ -1,8 +1,11 @@
+#include <unistd.h>
+
 #include "ogdf_instance.hpp"
 #include "ogdf_solver.hpp"
+#include "ogdf_stats.hpp"
 #include "ogdf_util.hpp"
 
-ogdf::Logger logger;
+thread_local ogdf::Logger logger;
 
 ogdf::node internal::idn(ogdf::node n) { return n; }
 
@@ -18,22 +21,31 @@ int main(int argc, char** argv) {
 	logger.localLogLevel(ogdf::Logger::Level::Default);
 	ogdf::Logger::globalLogLevel(ogdf::Logger::Level::Default);
 	Instance I;
+	InputBuffer input;
+	if (!input.readFd(STDIN_FILENO)) {
+		std::cerr << "Error reading input" << std::endl;
+		return 1;
+	}
 #ifdef OGDF_DEBUG
+	// unreduced copy for checking the solution
 	std::vector<ogdf::node> ID2node;
-	I.read(std::cin, ID2node);
 	Instance I2;
-	ogdf::NodeArray<ogdf::node> nMap(I.G, nullptr);
-	ogdf::EdgeArray<ogdf::edge> eMap(I.G, nullptr);
-	I2.G.insert(I.G, nMap, eMap);
-	I2.initFrom(I, I.G.nodes, I.G.edges, nMap, eMap);
-	for (auto& e : ID2node) {
-		e = e == nullptr ? nullptr : nMap[e];
-	}
-#else
-	I.read(std::cin);
 #endif
-
 	auto start = std::chrono::high_resolution_clock::now();
+	{
+		// run the cheap reductions on the flat graph before building the ogdf::Graph
+		FlatInstance F;
+		{
+			InstanceCSR csr;
+			readInstanceCSR(input, csr, paceThreads());
+#ifdef OGDF_DEBUG
+			I2.initFromCSR(csr, ID2node);
+#endif
+			F.initFromCSR(csr);
+		}
+		F.reduce();
+		I.initFromFlat(F);
+	}
 	reduceAndSolve(I, 0);
 	auto end = std::chrono::high_resolution_clock::now();
 
@@ -46,6 +58,7 @@ int main(int argc, char** argv) {
 		   << "\nc solve time: "
 		   << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms"
 		   << std::endl;
+	writeReductionStats();
 
 #ifdef OGDF_DEBUG
 	ogdf::Logger::globalLogLevel(ogdf::Logger::Level::Alarm);
@@ -0,0 +1,94 @@
+#include "ogdf_parallel.hpp"
+
+// index of the queue owned by the current thread, 0 for threads outside the pool
+static thread_local unsigned int own_queue = 0;
+
+TaskPool& TaskPool::get() {
+	// never destroyed, so that std::exit from within a task does not wait for the workers
+	static TaskPool* pool = new TaskPool(paceThreads());
+	return *pool;
+}
+
+TaskPool::TaskPool(unsigned int threads) {
+	for (unsigned int i = 0; i < threads; ++i) {
+		queues.push_back(std::make_unique<Queue>());
+	}
+	for (unsigned int i = 1; i < threads; ++i) {
+		workers.emplace_back(&TaskPool::workerLoop, this, i);
+	}
+}
+
+void TaskPool::push(std::vector<Task>& batch) {
+	auto& q = *queues[own_queue];
+	{
+		std::lock_guard<std::mutex> lock(q.mutex);
+		q.tasks.insert(q.tasks.begin(), std::make_move_iterator(batch.begin()),
+				std::make_move_iterator(batch.end()));
+		queued += batch.size();
+	}
+	batch.clear();
+	notify();
+}
+
+bool TaskPool::runOne() {
+	if (queued == 0) {
+		return false;
+	}
+	for (unsigned int i = 0; i < queues.size(); ++i) {
+		auto& q = *queues[(own_queue + i) % queues.size()];
+		Task task;
+		{
+			std::lock_guard<std::mutex> lock(q.mutex);
+			if (q.tasks.empty()) {
+				continue;
+			}
+			task = std::move(q.tasks.front());
+			q.tasks.pop_front();
+			--queued;
+		}
+		task();
+		return true;
+	}
+	return false;
+}
+
+void TaskPool::workerLoop(unsigned int id) {
+	own_queue = id;
+	while (true) {
+		if (!runOne()) {
+			idle([] { return false; });
+		}
+	}
+}
+
+void TaskGroup::run(std::function<void()> f) {
+	++open;
+	batch.push_back([this, f = std::move(f)] {
+		try {
+			f();
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(error_mutex);
+			if (!error) {
+				error = std::current_exception();
+			}
+		}
+		if (--open == 0) {
+			TaskPool::get().notify();
+		}
+	});
+}
+
+void TaskGroup::wait() {
+	auto& pool = TaskPool::get();
+	pool.push(batch);
+	while (open > 0) {
+		if (!pool.runOne()) {
+			pool.idle([this] { return open == 0; });
+		}
+	}
+	if (error) {
+		auto e = error;
+		error = nullptr;
+		std::rethrow_exception(e);
+	}
+}
@@ -0,0 +1,117 @@
+#include "ogdf_partition.hpp"
+
+void PartitionRefinement::init(size_t n) {
+	perm.clear();
+	bag_of.assign(n, NONE);
+	pos.resize(n);
+	bags.clear();
+	sub_of.clear();
+	sup_of.clear();
+	sup_next.clear();
+	touched.clear();
+	first_new = 0;
+}
+
+int PartitionRefinement::addBag() {
+	OGDF_ASSERT(touched.empty());
+	Bag bag;
+	bag.begin = bag.end = perm.size();
+	bags.push_back(bag);
+	first_new = bags.size();
+	return bags.size() - 1;
+}
+
+void PartitionRefinement::insert(int v) {
+	OGDF_ASSERT(!bags.empty() && bags.back().end == perm.size() && bag_of[v] == NONE);
+	bag_of[v] = bags.size() - 1;
+	pos[v] = perm.size();
+	perm.push_back(v);
+	bags.back().end++;
+}
+
+void PartitionRefinement::addEntry(int sup, int sub) {
+	sub_of.push_back(sub);
+	sup_of.push_back(sup);
+	sup_next.push_back(bags[sub].sup_head);
+	bags[sub].sup_head = sub_of.size() - 1;
+	bags[sub].supersets++;
+}
+
+void PartitionRefinement::removeBag(int b) {
+	Bag& bag = bags[b];
+	OGDF_ASSERT(!bag.removed && bag.begin == bag.end);
+	bag.removed = true;
+	for (size_t e = bag.sub_begin; e < bag.sub_end; ++e) {
+		if (!bags[sub_of[e]].removed) {
+			bags[sub_of[e]].supersets--;
+		}
+	}
+}
+
+void PartitionRefinement::remove(int v) {
+	OGDF_ASSERT(touched.empty());
+	int b = bag_of[v];
+	swapPositions(pos[v], bags[b].end - 1);
+	bags[b].end--;
+	bag_of[v] = NONE;
+	if (bags[b].begin == bags[b].end) {
+		removeBag(b);
+	}
+}
+
+void PartitionRefinement::touch(int v) {
+	int b = bag_of[v];
+	OGDF_ASSERT(b != NONE && b < (int)first_new);
+	if (bags[b].refined == NONE) {
+		bags[b].refined = bags.size();
+		Bag bag;
+		bag.begin = bag.end = bags[b].begin;
+		bags.push_back(bag);
+		touched.push_back(b);
+	}
+	// the new bag ends where the rest of the old one begins
+	int nb = bags[b].refined;
+	swapPositions(pos[v], bags[b].begin);
+	bags[b].begin++;
+	bags[nb].end++;
+	bag_of[v] = nb;
+}
+
+void PartitionRefinement::finishRound() {
+	// The new bag has strictly larger sets than its old bag and everything below it, and than the
+	// new bags split off from those in this round. The segments of older bags stay valid, as the
+	// new bags contain the refiner of this round and the older bags do not.
+	for (int b : touched) {
+		int nb = bags[b].refined;
+		bags[nb].sub_begin = sub_of.size();
+		addEntry(nb, b);
+		for (size_t e = bags[b].sub_begin; e < bags[b].sub_end; ++e) {
+			int x = sub_of[e];
+			if (bags[x].removed) {
+				continue;
+			}
+			addEntry(nb, x);
+			if (bags[x].refined != NONE) {
+				addEntry(nb, bags[x].refined);
+			}
+		}
+		bags[nb].sub_end = sub_of.size();
+	}
+	for (int b : touched) {
+		bags[b].refined = NONE;
+		if (bags[b].begin == bags[b].end) {
+			removeBag(b);
+		}
+	}
+	touched.clear();
+	first_new = bags.size();
+}
+
+bool PartitionRefinement::hasSubset(int b) const {
+	for (size_t e = bags[b].sub_begin; e < bags[b].sub_end; ++e) {
+		if (!bags[sub_of[e]].removed) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef PACE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef PACE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "ogdf_reader.hpp"
+
+static bool isGzip(const char* data, size_t size) {
+	return size >= 2 && (unsigned char)data[0] == 0x1f && (unsigned char)data[1] == 0x8b;
+}
+
+static bool isZstd(const char* data, size_t size) {
+	return size >= 4 && (unsigned char)data[0] == 0x28 && (unsigned char)data[1] == 0xb5
+			&& (unsigned char)data[2] == 0x2f && (unsigned char)data[3] == 0xfd;
+}
+
+bool InputBuffer::isCompressed(const char* data, size_t size) {
+	return isGzip(data, size) || isZstd(data, size);
+}
+
+#ifdef PACE_HAVE_ZLIB
+static bool inflateGzip(const char* data, size_t size, std::vector<char>& out) {
+	z_stream zs {};
+	// 15 + 32: maximum window size, detect zlib or gzip header
+	if (inflateInit2(&zs, 15 + 32) != Z_OK) {
+		return false;
+	}
+	zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	size_t used = 0;
+	int ret = Z_OK;
+	while (true) {
+		if (out.size() < used + InputBuffer::BLOCK_SIZE) {
+			out.resize(std::max(out.size() * 2, used + InputBuffer::BLOCK_SIZE));
+		}
+		// avail_in is only 32 bit wide, feed huge inputs piecewise
+		size_t consumed = reinterpret_cast<const char*>(zs.next_in) - data;
+		zs.avail_in = std::min<size_t>(size - consumed, 1u << 30);
+		zs.next_out = reinterpret_cast<Bytef*>(out.data() + used);
+		zs.avail_out = std::min<size_t>(out.size() - used, 1u << 30);
+		size_t before = zs.avail_out;
+		ret = inflate(&zs, Z_NO_FLUSH);
+		used += before - zs.avail_out;
+		if (ret == Z_STREAM_END) {
+			consumed = reinterpret_cast<const char*>(zs.next_in) - data;
+			// concatenated gzip members, as produced by e.g. `cat a.gz b.gz` or pigz
+			if (consumed < size && isGzip(data + consumed, size - consumed)) {
+				inflateReset(&zs);
+				continue;
+			}
+			break;
+		}
+		if (ret != Z_OK && ret != Z_BUF_ERROR) {
+			break;
+		}
+		if (ret == Z_BUF_ERROR && zs.avail_in == 0) {
+			break; // truncated input
+		}
+	}
+	inflateEnd(&zs);
+	out.resize(used);
+	return ret == Z_STREAM_END;
+}
+#endif
+
+#ifdef PACE_HAVE_ZSTD
+static bool decompressZstd(const char* data, size_t size, std::vector<char>& out) {
+	ZSTD_DStream* zs = ZSTD_createDStream();
+	if (zs == nullptr) {
+		return false;
+	}
+	ZSTD_inBuffer in {data, size, 0};
+	size_t used = 0;
+	size_t ret = 0;
+	// ret != 0 means that the frame is not finished, zstd may still hold decoded output even when
+	// all input was consumed, so only stop once neither input nor output makes progress
+	while (in.pos < in.size || ret != 0) {
+		if (out.size() < used + InputBuffer::BLOCK_SIZE) {
+			out.resize(std::max(out.size() * 2, used + InputBuffer::BLOCK_SIZE));
+		}
+		ZSTD_outBuffer o {out.data() + used, out.size() - used, 0};
+		size_t before = in.pos;
+		ret = ZSTD_decompressStream(zs, &o, &in);
+		used += o.pos;
+		if (ZSTD_isError(ret) || (o.pos == 0 && in.pos == before)) {
+			break; // corrupt or truncated input
+		}
+	}
+	ZSTD_freeDStream(zs);
+	out.resize(used);
+	return !ZSTD_isError(ret) && ret == 0;
+}
+#endif
+
+InputBuffer& InputBuffer::operator=(InputBuffer&& other) noexcept {
+	if (this != &other) {
+		release();
+		heap_ = std::move(other.heap_);
+		map_ = other.map_;
+		mapSize_ = other.mapSize_;
+		size_ = other.size_;
+		data_ = map_ != nullptr ? other.data_ : heap_.data();
+		other.map_ = nullptr;
+		other.mapSize_ = 0;
+		other.data_ = nullptr;
+		other.size_ = 0;
+	}
+	return *this;
+}
+
+void InputBuffer::release() {
+	if (map_ != nullptr) {
+		munmap(map_, mapSize_);
+		map_ = nullptr;
+		mapSize_ = 0;
+	}
+	heap_.clear();
+	heap_.shrink_to_fit();
+	data_ = nullptr;
+	size_ = 0;
+}
+
+bool InputBuffer::openFile(const std::string& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	bool ok = readFd(fd);
+	close(fd);
+	return ok;
+}
+
+bool InputBuffer::decompress() {
+	if (!isCompressed(data_, size_)) {
+		return true;
+	}
+	std::vector<char> out;
+	bool ok = false;
+	if (isGzip(data_, size_)) {
+#ifdef PACE_HAVE_ZLIB
+		ok = inflateGzip(data_, size_, out);
+#else
+		std::cerr << "Input is gzip compressed, but zlib support was not compiled in" << std::endl;
+#endif
+	} else {
+#ifdef PACE_HAVE_ZSTD
+		ok = decompressZstd(data_, size_, out);
+#else
+		std::cerr << "Input is zstd compressed, but zstd support was not compiled in" << std::endl;
+#endif
+	}
+	release();
+	if (ok) {
+		heap_ = std::move(out);
+		data_ = heap_.data();
+		size_ = heap_.size();
+	}
+	return ok;
+}
+
+bool InputBuffer::readFd(int fd) {
+	release();
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+		// the mapping is only valid from the current file offset on, so start there
+		off_t offset = lseek(fd, 0, SEEK_CUR);
+		if (offset < 0) {
+			offset = 0;
+		}
+		void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (m != MAP_FAILED) {
+			madvise(m, st.st_size, MADV_SEQUENTIAL);
+			map_ = m;
+			mapSize_ = st.st_size;
+			data_ = static_cast<const char*>(m) + std::min<off_t>(offset, st.st_size);
+			size_ = st.st_size - std::min<off_t>(offset, st.st_size);
+			return decompress();
+		}
+	}
+
+	size_t used = 0;
+	while (true) {
+		if (heap_.size() < used + BLOCK_SIZE) {
+			heap_.resize(std::max(heap_.size() * 2, used + BLOCK_SIZE));
+		}
+		ssize_t r = ::read(fd, heap_.data() + used, heap_.size() - used);
+		if (r < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		if (r == 0) {
+			break;
+		}
+		used += r;
+	}
+	heap_.resize(used);
+	data_ = heap_.data();
+	size_ = used;
+	return decompress();
+}
+
+bool InputBuffer::readStream(std::istream& is) {
+	release();
+	size_t used = 0;
+	while (is.good()) {
+		if (heap_.size() < used + BLOCK_SIZE) {
+			heap_.resize(std::max(heap_.size() * 2, used + BLOCK_SIZE));
+		}
+		is.read(heap_.data() + used, heap_.size() - used);
+		used += is.gcount();
+	}
+	heap_.resize(used);
+	data_ = heap_.data();
+	size_ = used;
+	return !is.bad() && decompress();
+}
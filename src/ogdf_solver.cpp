@@ -1,7 +1,25 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include "ogdf_solver.hpp"
 #include "ogdf_cliquesolver.h"
+#include "ogdf_parallel.hpp"
+#include "ogdf_stats.hpp"
 #include "ogdf_treewidth.h"
 
+template<typename F>
+static bool runRule(const char* rule, int d, Instance& I, F&& f) {
+	ScopedRuleTimer<Instance> timer(rule, d, I);
+	return timer(f());
+}
+
 void reduceAndSolve(Instance& I, int d) {
 	bool changed = true;
 	int m, n, i = 0;
@@ -14,7 +32,7 @@ void reduceAndSolve(Instance& I, int d) {
 			<< " edges" << std::endl;
 
 		// this reduction is so cheap, make sure we really have no isolated vertices before decomposing components
-		while (I.reductionExtremeDegrees()) {
+		while (runRule("extreme_degrees", d, I, [&] { return I.reductionExtremeDegrees(); })) {
 			changed = true;
 		}
 
@@ -23,32 +41,45 @@ void reduceAndSolve(Instance& I, int d) {
 			log << comps.size() << " connected components" << std::endl;
 			I.clear(); // save some memory
 
+			// start with the largest components, so that the small ones fill up the gaps at the end
+			comps.sort([](const Instance& a, const Instance& b) {
+				return a.G.numberOfNodes() > b.G.numberOfNodes();
+			});
+			TaskGroup group;
 			int c = 0;
 			for (auto& comp : comps) {
-				log << "Connected component " << c << std::endl;
-				ogdf::Logger::Indent _(logger);
-				++c;
+				group.run([&comp, c, d] {
+					log << "Connected component " << c << std::endl;
+					ogdf::Logger::Indent _(logger);
 
-				// and now recurse
-				reduceAndSolve(comp, d + 1);
-				I.addToDominatingSet(comp.DS.begin(), comp.DS.end(),
-						"connected component " + std::to_string(c));
+					// and now recurse
+					reduceAndSolve(comp, d + 1);
+				});
+				++c;
+			}
+			group.wait();
+			// merge in a fixed order, independent of which thread finished first
+			c = 0;
+			for (auto& comp : comps) {
+				++c;
+				I.addToDominatingSet(comp.DS, "connected component " + std::to_string(c));
 			}
 			return;
 		}
 
-		if (I.reductionNeighborhoodSubsets()) {
+		if (runRule("neighborhood_subsets", d, I,
+					[&] { return I.reductionNeighborhoodSubsets(); })) {
 			changed = true;
-		} else if (I.reductionContraction()) {
+		} else if (runRule("contraction", d, I, [&] { return I.reductionContraction(); })) {
 			changed = true;
-		} else if (I.reductionSpecial1()) {
+		} else if (runRule("special1", d, I, [&] { return I.reductionSpecial1(); })) {
 			changed = true;
-		} else if (I.reductionSpecial2(d)) {
+		} else if (runRule("special2", d, I, [&] { return I.reductionSpecial2(d); })) {
 			// instance is solved here
 			return;
 			// } else if (I.isVCInstance() && I.reductionVCLP()) { // THIS does not work properly yet!! And it also does not reduce somehow
 			// 	changed = true;
-		} else if (I.reductionBCTree(d)) {
+		} else if (runRule("bc_tree", d, I, [&] { return I.reductionBCTree(d); })) {
 			changed = true;
 		// } else if (I.reductionNeighborhoodVW()) {
 		// 	changed = true;
@@ -74,36 +105,190 @@ void reduceAndSolve(Instance& I, int d) {
 	ReductionTreeDecomposition rtd(I.G, I);
 	rtd.computeDecomposition();
 	int ansdp = -1;
-	if (rtd.decomposition != nullptr) {
+	if (rtd.hasDecomposition()) {
 		log << "Decomposition found with treewidth " << rtd.treewidth << std::endl;
-		if (rtd.treewidth <= 13) {
+		if (rtd.fitsDPMemory()) {
 			log << "Solving with DP" << std::endl;
 			ansdp = rtd.solveDPExact();
-			return;
+			if (ansdp >= 0) {
+				return;
+			}
 		}
 	}
 
 	if (I.isVCInstance() && I.numNotSubsumed() < 1000) {
-		if (solveMISInstanceWithCliqueSolver(I, 100000000, true, 300)) {
+		if (solveMISInstanceWithCliqueSolver(I, 100000000, true, 300, d)) {
 			return;
 		}
 	}
 
-#ifdef USE_ORTOOLS
-	solvecpsat(I);
-#elif USE_GUROBI
-	solveGurobiExactGurobi(I);
-#elif USE_UWRMAXSAT
-	solveIPAMIR(I);
-#elif USE_EVALMAXSAT
 	int anssat = I.DS.size();
-	solveEvalMaxSat(I);
+	solveExact(I);
 	anssat = I.DS.size() - anssat;
 	if (ansdp != -1) {
 		log << anssat << " vs. " << ansdp << std::endl;
 		OGDF_ASSERT(anssat == ansdp);
 	}
-#else
+}
+
+namespace {
+struct Backend {
+	const char* name;
+	const char* stats_name;
+	bool (*solve)(Instance&, DominatingSet&, Cancellation&);
+	bool interruptible; // whether it stops soon after being cancelled
+};
+
+// all backends compiled into this build, the stats name is the rule name in the PACE_STATS report
+const std::vector<Backend> BACKENDS = {
+#ifdef USE_ORTOOLS
+		{"cpsat", "solver_cpsat", solvecpsat, true},
+#endif
+#ifdef USE_GUROBI
+		{"gurobi", "solver_gurobi", solveGurobiExactGurobi, true},
+#endif
+#ifdef USE_UWRMAXSAT
+		{"uwrmaxsat", "solver_uwrmaxsat", solveIPAMIR, true},
+#endif
+#ifdef USE_EVALMAXSAT
+		{"evalmaxsat", "solver_evalmaxsat", solveEvalMaxSat, false},
+#endif
+};
+}
+
+#if !defined(USE_ORTOOLS) && !defined(USE_GUROBI) && !defined(USE_UWRMAXSAT) \
+		&& !defined(USE_EVALMAXSAT)
 #	error "No Solver configured!"
 #endif
+
+static std::vector<const Backend*> selectedBackends() {
+	std::vector<const Backend*> selected;
+	const char* env = std::getenv("PACE_SOLVERS");
+	if (env == nullptr) {
+		for (const auto& b : BACKENDS) {
+			selected.push_back(&b);
+		}
+		return selected;
+	}
+	std::string list(env);
+	size_t start = 0;
+	while (start <= list.size()) {
+		size_t end = std::min(list.find(',', start), list.size());
+		std::string name = list.substr(start, end - start);
+		start = end + 1;
+		if (name.empty()) {
+			continue;
+		}
+		auto it = std::find_if(BACKENDS.begin(), BACKENDS.end(),
+				[&](const Backend& b) { return name == b.name; });
+		if (it == BACKENDS.end()) {
+			std::cerr << "Solver " << name << " from PACE_SOLVERS is not available, choose from:";
+			for (const auto& b : BACKENDS) {
+				std::cerr << " " << b.name;
+			}
+			std::cerr << std::endl;
+			std::exit(1);
+		}
+		selected.push_back(&*it);
+	}
+	if (selected.empty()) {
+		std::cerr << "PACE_SOLVERS does not name any solver" << std::endl;
+		std::exit(1);
+	}
+	return selected;
+}
+
+// The race has to wait for every backend, so one that cannot be cancelled would make it as slow as
+// that backend alone. Such backends only run if nothing else is selected.
+static std::vector<const Backend*> raceBackends() {
+	std::vector<const Backend*> selected = selectedBackends();
+	std::vector<const Backend*> race;
+	for (auto b : selected) {
+		if (b->interruptible) {
+			race.push_back(b);
+		}
+	}
+	if (race.empty()) {
+		return selected;
+	}
+	for (auto b : selected) {
+		if (!b->interruptible) {
+			log << "Solver " << b->name << " cannot be cancelled and does not take part in the race"
+				<< std::endl;
+		}
+	}
+	return race;
+}
+
+static const std::vector<const Backend*>& exactBackends() {
+	static const std::vector<const Backend*> backends = raceBackends();
+	return backends;
+}
+
+bool exactBackendSelected(const char* name) {
+	const auto& backends = exactBackends();
+	return std::any_of(backends.begin(), backends.end(),
+			[&](const Backend* b) { return std::strcmp(b->name, name) == 0; });
+}
+
+void solveExact(Instance& I) {
+	const auto& backends = exactBackends();
+#ifdef SAT_CACHE
+	std::vector<std::vector<int>> hclauses = sat_cache_clauses(I);
+	std::string cache_file;
+	{
+		DominatingSet cached;
+		if (try_load_solution(cached, hclauses, cache_file)) {
+			I.addToDominatingSet(cached, "SAT cache");
+			return;
+		}
+	}
+#endif
+	std::vector<DominatingSet> solutions(backends.size());
+	std::vector<std::exception_ptr> errors(backends.size());
+	std::atomic<int> winner {-1};
+	Cancellation cancel;
+
+	// The solvers block their thread for a long time, so they get threads of their own instead of
+	// pool workers. The first one to prove optimality cancels the others.
+	parallelFor(backends.size(), [&](unsigned int i) {
+		auto start = std::chrono::steady_clock::now();
+		bool won = false;
+		try {
+			int none = -1;
+			if (backends[i]->solve(I, solutions[i], cancel)
+					&& winner.compare_exchange_strong(none, i)) {
+				won = true;
+				cancel.cancel();
+			}
+		} catch (...) {
+			errors[i] = std::current_exception();
+		}
+		// the backends race once per solved component, `applied` counts how often each one won
+		if (reductionStatsEnabled()) {
+			RuleCounters c;
+			c.calls = 1;
+			c.applied = won;
+			c.nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start)
+							  .count();
+			c.ds_added = won ? solutions[i].size() : 0;
+			recordReductionStats(backends[i]->stats_name, 0, c);
+		}
+	});
+
+	if (winner < 0) {
+		for (auto& error : errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+		throw std::runtime_error("No solver found an optimal result!");
+	}
+	log << "Solver " << backends[winner]->name << " won against " << backends.size() - 1
+		<< " others" << std::endl;
+#ifdef SAT_CACHE
+	store_solution(cache_file, hclauses, solutions[winner]);
+#endif
+	I.addToDominatingSet(solutions[winner], backends[winner]->name);
 }
@@ -1,7 +1,60 @@
+#include <fstream>
+#include <thread>
+
 #include "ogdf_instance.hpp"
 #include "ogdf_solver.hpp"
 #include "ogdf_util.hpp"
 
+// the clauses of the MaxSAT / ILP encoding by node IDs, each sorted, as key of the cache
+std::vector<std::vector<int>> sat_cache_clauses(Instance& I) {
+	std::vector<std::vector<int>> hclauses;
+	hclauses.reserve(I.G.numberOfNodes());
+	for (auto v : I.G.nodes) {
+		if (I.is_dominated[v]) {
+			continue;
+		}
+		hclauses.emplace_back();
+		auto& clause = hclauses.back();
+		clause.reserve(v->indeg() + 1);
+		if (!I.is_subsumed[v]) {
+			clause.push_back(I.node2ID[v]);
+		}
+		auto add_neigh = [&](ogdf::adjEntry adj) {
+			auto w = adj->twinNode();
+			if (!adj->isSource() && !I.is_subsumed[w]) {
+				clause.push_back(I.node2ID[w]);
+			}
+			return true;
+		};
+		forAllInAdj(v, add_neigh);
+		ogdf::safeForEach(I.hidden_edges.adjEntries(v), add_neigh);
+		std::sort(clause.begin(), clause.end());
+	}
+	return hclauses;
+}
+
+// Write to a temporary file first, so that a concurrent reader (or a writer of an identical
+// component) never sees a partial file.
+template<typename F>
+static void write_atomically(const std::string& file, F&& f) {
+	std::string tmp = file + ".tmp"
+			+ std::to_string(std::hash<std::thread::id> {}(std::this_thread::get_id()));
+	bool ok;
+	{
+		std::ofstream out(tmp);
+		f(out);
+		ok = out.good();
+	}
+	std::error_code ec;
+	if (ok) {
+		std::filesystem::rename(tmp, file, ec);
+	}
+	if (!ok || ec) {
+		std::cerr << "Could not write cache file " << file << std::endl;
+		std::filesystem::remove(tmp, ec);
+	}
+}
+
 uint64_t hash_clauses(const std::vector<std::vector<int>>& clauses) {
 	uint64_t hash = FNV1a_64_SEED;
 	OGDF_ASSERT(clauses.size() > 0);
@@ -17,36 +70,67 @@ uint64_t hash_clauses(const std::vector<std::vector<int>>& clauses) {
 }
 
 void dump_sat(const std::string& file, const std::vector<std::vector<int>>& clauses) {
-	std::ofstream f(file);
-	for (auto& clause : clauses) {
-		bool first = true;
-		for (auto x : clause) {
-			if (first) {
-				first = false;
-			} else {
-				f << " ";
+	write_atomically(file, [&](std::ostream& f) {
+		for (auto& clause : clauses) {
+			bool first = true;
+			for (auto x : clause) {
+				if (first) {
+					first = false;
+				} else {
+					f << " ";
+				}
+				f << x;
 			}
-			f << x;
+			f << "\n";
+		}
+	});
+}
+
+// cache files may have been compressed in place, e.g. by `gzip cache/*`
+std::string find_cache_file(const std::string& file) {
+	for (const char* ext : {"", ".gz", ".zst"}) {
+		if (std::filesystem::exists(file + ext)) {
+			return file + ext;
 		}
-		f << "\n";
 	}
+	return "";
 }
 
-bool is_same_sat(const std::string& file, const std::vector<std::vector<int>>& clauses) {
-	std::ifstream f(file);
-	int a;
-	for (auto& clause : clauses) {
-		for (auto x : clause) {
-			if (!(f >> a) || a != x) {
+// calls f for every number in the (possibly compressed) file, stops early if f returns false
+template<typename F>
+static bool for_all_numbers(const std::string& file, F&& f) {
+	InputBuffer buf;
+	if (file.empty() || !buf.openFile(file)) {
+		return false;
+	}
+	LineScanner sc(buf.begin(), buf.end());
+	unsigned int a;
+	while (sc.nextDataLine()) {
+		while (sc.readUInt(a)) {
+			if (!f(a)) {
 				return false;
 			}
 		}
+		sc.skipLine();
 	}
-	if (f >> a) {
-		return false;
-	} else {
+	return true;
+}
+
+bool is_same_sat(const std::string& file, const std::vector<std::vector<int>>& clauses) {
+	// clauses are never empty, see hash_clauses
+	auto clause = clauses.begin();
+	size_t i = 0;
+	bool same = for_all_numbers(find_cache_file(file), [&](unsigned int a) {
+		if (clause == clauses.end() || (int)a != (*clause)[i]) {
+			return false;
+		}
+		if (++i == clause->size()) {
+			++clause;
+			i = 0;
+		}
 		return true;
-	}
+	});
+	return same && clause == clauses.end();
 }
 
 std::string get_filename(uint64_t hash, const std::string& ext, const std::string& dir) {
@@ -57,14 +141,15 @@ std::string get_filename(uint64_t hash, const std::string& ext, const std::strin
 	return fnstr.str();
 }
 
-bool try_load_solution(Instance& I, std::vector<std::vector<int>>& hclauses, std::string& filename) {
+bool try_load_solution(
+		DominatingSet& DS, std::vector<std::vector<int>>& hclauses, std::string& filename) {
 	std::sort(hclauses.begin(), hclauses.end());
 	uint64_t hash = hash_clauses(hclauses);
 	filename = get_filename(hash, ".sol");
 	std::string filename_sat = get_filename(hash, ".sat");
 
-	int before = I.DS.size();
-	if (std::filesystem::exists(filename)) {
+	int before = DS.size();
+	if (!find_cache_file(filename).empty()) {
 		log << "Found cached solution " << filename << std::endl;
 		bool can_load = true;
 		if (!is_same_sat(filename_sat, hclauses)) {
@@ -74,7 +159,7 @@ bool try_load_solution(Instance& I, std::vector<std::vector<int>>& hclauses, std
 			for (int i = 0; i < 100; ++i) {
 				filename = get_filename(hash, ".sol.col" + std::to_string(i));
 				filename_sat = get_filename(hash, ".sat.col" + std::to_string(i));
-				if (!std::filesystem::exists(filename)) {
+				if (find_cache_file(filename).empty()) {
 					break;
 				} else if (is_same_sat(filename_sat, hclauses)) {
 					log << "Will load solution from " << filename
@@ -86,16 +171,15 @@ bool try_load_solution(Instance& I, std::vector<std::vector<int>>& hclauses, std
 		}
 		if (can_load) {
 			auto& l = logger.lout(ogdf::Logger::Level::Minor) << "Add to DS:";
-			std::ifstream f(filename);
-			int id;
-			while (f >> id) {
-				I.DS.insert(id);
+			for_all_numbers(find_cache_file(filename), [&](unsigned int id) {
+				DS.insert(id);
 				l << " " << id;
-			}
+				return true;
+			});
 			l << "\n";
-			if (I.DS.size() > before) {
-				log << "Updated DS (cached): " << before << "+" << (I.DS.size() - before) << "="
-					<< I.DS.size() << std::endl;
+			if (DS.size() > before) {
+				log << "Updated DS (cached): " << before << "+" << (DS.size() - before) << "="
+					<< DS.size() << std::endl;
 				return true;
 			} else {
 				log << "Cached file seems empty, discarding!" << std::endl;
@@ -104,7 +188,19 @@ bool try_load_solution(Instance& I, std::vector<std::vector<int>>& hclauses, std
 	}
 
 	log << "Will cache solution in " << filename << std::endl;
+	return false;
+}
+
+void store_solution(const std::string& filename, const std::vector<std::vector<int>>& hclauses,
+		const DominatingSet& DS) {
+	// the .sat file belongs to the .sol file with the same suffix, see try_load_solution
+	std::string filename_sat = filename;
+	filename_sat.replace(filename_sat.rfind(".sol"), 4, ".sat");
 	std::filesystem::create_directory("cache");
 	dump_sat(filename_sat, hclauses);
-	return false;
+	write_atomically(filename, [&](std::ostream& f) {
+		for (int id : DS) {
+			f << " " << id;
+		}
+	});
 }
@@ -1,146 +1,145 @@
+#include <memory>
+#include <mutex>
+#include <optional>
+
 #include "EvalMaxSAT.h"
 #include "matching.hpp"
 
 #include "ogdf_solver.hpp"
 #include "ogdf_util.hpp"
 
-void createSolver(Instance& I, EvalMaxSAT<Solver_cadical>* solver, ogdf::NodeArray<int>& varmap,
-		std::vector<std::vector<int>>& hclauses,
-		std::vector<std::pair<ogdf::node, ogdf::node>>& size_2_clauses) {
+// The hard clauses of the MaxSAT encoding, built once from the graph and loaded into as many
+// solvers as needed. Variable i (from 0) is the soft variable of the i-th non-subsumed node.
+struct DSEncoding {
+	std::vector<ogdf::node> nodes;
+	// the variables of clause c are literals[begin[c]], ..., literals[begin[c+1]-1]
+	std::vector<int> literals;
+	std::vector<size_t> begin {0};
+	std::vector<std::pair<int, int>> binary; // the clauses with two variables
+};
+
+static void encode(Instance& I, DSEncoding& enc) {
+	ogdf::NodeArray<int> index(I.G, -1);
 	for (auto v : I.G.nodes) {
 		if (I.is_subsumed[v]) {
 			continue;
 		}
-		int var = solver->newSoftVar(true, -1);
-		varmap[v] = var;
+		index[v] = enc.nodes.size();
+		enc.nodes.push_back(v);
 	}
 
-#ifdef SAT_CACHE
-	hclauses.reserve(I.G.numberOfNodes());
-#endif
-	std::vector<int> clause;
 	for (auto v : I.G.nodes) {
 		if (I.is_dominated[v]) {
 			continue;
 		}
-		std::vector<ogdf::node> nodes_in_clause;
-		clause.clear();
-		// clause.reserve(v->indeg() + 1);
-#ifdef SAT_CACHE
-		hclauses.emplace_back();
-		hclauses.back().reserve(v->indeg() + 1);
-#endif
+		size_t first = enc.literals.size();
 		if ((!I.is_subsumed[v] && !I.is_dominated[v]) || I.is_hidden_loop[v]) {
-			clause.push_back(varmap[v]);
-			nodes_in_clause.push_back(v);
-#ifdef SAT_CACHE
-			hclauses.back().push_back(I.node2ID[v]);
-#endif
+			OGDF_ASSERT(index[v] >= 0);
+			enc.literals.push_back(index[v]);
 		}
 		auto add_neigh = [&](ogdf::adjEntry adj) {
 			auto w = adj->twinNode();
 			if (!adj->isSource() && !I.is_subsumed[w]) {
-				clause.push_back(varmap[w]);
-				nodes_in_clause.push_back(w);
-#ifdef SAT_CACHE
-				hclauses.back().push_back(I.node2ID[w]);
-#endif
+				enc.literals.push_back(index[w]);
 			}
 			return true;
 		};
 		forAllInAdj(v, add_neigh);
-		if (clause.empty()) {
+		if (enc.literals.size() == first) {
 			continue;
 		}
-		solver->addClause(clause); //hard clause
-
-		if (clause.size() == 2) {
-			auto uu = nodes_in_clause[0];
-			auto vv = nodes_in_clause[1];
-			size_2_clauses.push_back({uu, vv});
+		enc.begin.push_back(enc.literals.size());
+		if (enc.literals.size() - first == 2) {
+			enc.binary.emplace_back(enc.literals[first], enc.literals[first + 1]);
 		}
-
-#ifdef SAT_CACHE
-		std::sort(hclauses.back().begin(), hclauses.back().end());
-#endif
 	}
 }
 
-void solveEvalMaxSat(Instance& I) {
-	EvalMaxSAT<Solver_cadical>* solver = new EvalMaxSAT();
-	int before = I.DS.size();
-	log << "Solving EvalMaxSat with " << I.G.numberOfNodes() << " nodes" << std::endl;
-	ogdf::NodeArray<int> varmap(I.G, -1);
-	ogdf::NodeArray<int> mapBlossom(I.G, -1);
-	std::vector<ogdf::node> mapBlossomInv;
-	std::vector<std::vector<int>> hclauses;
-	for (auto v : I.G.nodes) {
-		if (I.is_subsumed[v]) {
-			continue;
+// add the soft variables and hard clauses to a fresh solver, returns the solver variable of each
+// encoding variable
+static std::vector<int> load(const DSEncoding& enc, EvalMaxSAT<Solver_cadical>& solver) {
+	std::vector<int> vars;
+	vars.reserve(enc.nodes.size());
+	for (size_t i = 0; i < enc.nodes.size(); ++i) {
+		vars.push_back(solver.newSoftVar(true, -1));
+	}
+	std::vector<int> clause;
+	for (size_t c = 0; c + 1 < enc.begin.size(); ++c) {
+		clause.clear();
+		for (size_t i = enc.begin[c]; i < enc.begin[c + 1]; ++i) {
+			clause.push_back(vars[enc.literals[i]]);
 		}
-		mapBlossomInv.push_back(v);
-		mapBlossom[v] = mapBlossomInv.size() - 1;
+		solver.addClause(clause); //hard clause
 	}
-	std::vector<std::vector<int>> blossomadj(mapBlossomInv.size());
-	std::vector<std::pair<ogdf::node, ogdf::node>> size_2_clauses;
+	return vars;
+}
 
-	createSolver(I, solver, varmap, hclauses, size_2_clauses);
+// EvalMaxSAT and its CaDiCaL wrapper are not known to be reentrant (static timers and verbosity
+// settings), so only one solver is built or solved at a time
+static std::mutex evalmaxsat_mutex;
 
-#ifdef SAT_CACHE
-	std::string filename;
-	if (try_load_solution(I, hclauses, filename)) {
-		return;
+bool solveEvalMaxSat(Instance& I, DominatingSet& DS, Cancellation& cancel) {
+	log << "Solving EvalMaxSat with " << I.G.numberOfNodes() << " nodes" << std::endl;
+	DSEncoding enc;
+	encode(I, enc);
+
+	// the final solve cannot be interrupted, so cancellation is only checked before it
+	std::lock_guard<std::mutex> lock(evalmaxsat_mutex);
+	if (cancel.requested()) {
+		return false;
 	}
-	std::ofstream f(filename);
+	std::optional<QuietStdout> quiet;
+#ifndef PACE_LOG
+	quiet.emplace();
 #endif
-	for (auto& p : size_2_clauses) {
-		auto u = mapBlossom[p.first];
-		auto v = mapBlossom[p.second];
+	// Two lower bounds from the same encoding, once for the plain clauses and once with a maximum
+	// matching over the binary clauses as at-most-one constraints. Only one solver exists at a
+	// time: the plain one is dropped after its bound is known and only rebuilt if it was better.
+	auto loadPlain = [&](std::vector<int>& vars) {
+		auto solver = std::make_unique<EvalMaxSAT<Solver_cadical>>();
+		vars = load(enc, *solver);
+		solver->adapt_am1_exact();
+		solver->adapt_am1_FastHeuristicV7();
+		return solver;
+	};
+	std::vector<int> vars;
+	auto plain_cost = loadPlain(vars)->cost;
+	if (cancel.requested()) {
+		return false;
+	}
+
+	std::vector<std::vector<int>> blossomadj(enc.nodes.size());
+	for (auto [u, v] : enc.binary) {
 		blossomadj[u].push_back(v);
 		blossomadj[v].push_back(u);
 	}
 	Blossom matching_blossom(blossomadj);
 	auto ans = matching_blossom.solve();
-	auto matching_size = ans.second;
-
-#ifndef PACE_LOG
-	std::cout.setstate(std::ios::failbit); // https://stackoverflow.com/a/8246430
-#endif
+	blossomadj = {};
+	auto solver = std::make_unique<EvalMaxSAT<Solver_cadical>>();
+	vars = load(enc, *solver);
+	for (int u = 0; u < (int)ans.first.size(); u++) {
+		int v = ans.first[u];
+		if (v != -1 && u < v) {
+			solver->processAtMostOne({-vars[u], -vars[v]});
+		}
+	}
 	solver->adapt_am1_exact();
 	solver->adapt_am1_FastHeuristicV7();
-
-	{
-		// Try if matching plus heuristic gives better lower bound
-		EvalMaxSAT<Solver_cadical>* solver2 = new EvalMaxSAT();
-		hclauses.clear();
-		size_2_clauses.clear();
-		ogdf::NodeArray<int> varmap2(I.G, -1);
-		createSolver(I, solver2, varmap2, hclauses, size_2_clauses);
-		for (int i = 0; i < ans.first.size(); i++) {
-			if (ans.first[i] != -1) {
-				auto u = mapBlossomInv[i];
-				auto v = mapBlossomInv[ans.first[i]];
-				if (u > v) {
-					continue;
-				}
-				auto varu = varmap2[u];
-				auto varv = varmap2[v];
-				solver2->processAtMostOne({-varu, -varv});
-			}
-		}
-		solver2->adapt_am1_exact();
-		solver2->adapt_am1_FastHeuristicV7();
-		if (solver2->cost >= solver->cost) {
-			log << "Matching found better or at least as good lower bound" << std::endl;
-			log << "Matching size: " << matching_size << std::endl;
-			log << "Solver2 cost: " << solver2->cost << std::endl;
-			log << "Solver cost: " << solver->cost << std::endl;
-			delete solver;
-			varmap = varmap2;
-			solver = solver2;
-		} else {
-			delete solver2;
+	if (solver->cost >= plain_cost) {
+		log << "Matching found better or at least as good lower bound" << std::endl;
+		log << "Matching size: " << ans.second << std::endl;
+		log << "Matching solver cost: " << solver->cost << std::endl;
+		log << "Plain solver cost: " << plain_cost << std::endl;
+	} else {
+		solver.reset();
+		if (cancel.requested()) {
+			return false;
 		}
+		solver = loadPlain(vars);
+	}
+	if (cancel.requested()) {
+		return false;
 	}
 	// set parameters as default divided by divide_by, otherwise each core finding takes too long
 	// double divide_by = 2; // as evalmaxsat is made for 1 hour, this seems reasonable as we have 30 minutes.
@@ -148,27 +147,20 @@ void solveEvalMaxSat(Instance& I) {
 	solver->setBoundRefTime(5 / PACE_EMS_FACTOR, (5 * 60) / PACE_EMS_FACTOR);
 	solver->setCoef(10, 1.66);
 	bool solved = solver->solve();
-#ifndef PACE_LOG
-	std::cout.clear();
-#endif
+	quiet.reset();
 	if (!solved) {
 		throw std::runtime_error("EvalMaxSAT didn't find optimal result!");
 	}
 
 	auto& l = logger.lout(ogdf::Logger::Level::Minor) << "Add to DS:";
-	for (auto v : I.G.nodes) {
-		if (!I.is_subsumed[v]) {
-			if (solver->getValue(varmap[v])) {
-				I.DS.insert(I.node2ID[v]);
-				l << " " << I.node2ID[v];
-#ifdef SAT_CACHE
-				f << " " << I.node2ID[v];
-#endif
-			}
+	for (size_t i = 0; i < enc.nodes.size(); ++i) {
+		if (solver->getValue(vars[i])) {
+			auto v = enc.nodes[i];
+			DS.insert(I.node2ID[v]);
+			l << " " << I.node2ID[v];
 		}
 	}
 	l << "\n";
-	log << "Updated DS (solved " << solved << "): " << before << "+" << (I.DS.size() - before)
-		<< "=" << I.DS.size() << std::endl;
-	delete solver;
+	log << "EvalMaxSat solution size " << DS.size() << std::endl;
+	return true;
 }
@@ -2,7 +2,7 @@
 #include "ogdf_solver.hpp"
 #include "ogdf_util.hpp"
 
-void solveGurobiExactGurobi(Instance& instance) {
+bool solveGurobiExactGurobi(Instance& instance, DominatingSet& DS, Cancellation& cancel) {
 	GRBEnv env;
 	GRBModel model(env);
 
@@ -39,7 +39,13 @@ void solveGurobiExactGurobi(Instance& instance) {
 		model.addConstr(expr >= 1);
 	}
 
-	model.optimize();
+	{
+		Cancellation::Hook interrupt(cancel, [&] { model.terminate(); });
+		model.optimize();
+	}
+	if (model.get(GRB_IntAttr_Status) != GRB_OPTIMAL && cancel.requested()) {
+		return false;
+	}
 
 	auto& l = logger.lout(ogdf::Logger::Level::Minor) << "Add to DS:";
 	for (auto v : instance.G.nodes) {
@@ -47,8 +53,10 @@ void solveGurobiExactGurobi(Instance& instance) {
 			continue;
 		}
 		if (varmap[v].get(GRB_DoubleAttr_X) > 0.5) {
-			instance.addToDominatingSet(v);
+			DS.insert(instance.node2ID[v]);
 			l << " " << instance.node2ID[v];
 		}
 	}
+	l << "\n";
+	return true;
 }
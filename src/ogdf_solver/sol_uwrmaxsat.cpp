@@ -1,11 +1,20 @@
+#include <mutex>
+
 #include "ogdf_solver.hpp"
 #include "ogdf_util.hpp"
 
 #include <uwrmaxsat/ipamir.h>
 
-void solveIPAMIR(Instance& I) {
+// UWrMaxSat keeps Minisat-style global state (options, statistics, the PB encoder), so no two
+// IPAMIR calls may run at the same time, even on different solver instances
+static std::mutex ipamir_mutex;
+
+bool solveIPAMIR(Instance& I, DominatingSet& DS, Cancellation& cancel) {
+	std::lock_guard<std::mutex> lock(ipamir_mutex);
+	if (cancel.requested()) {
+		return false;
+	}
 	void* ipamir = ipamir_init();
-	int before = I.DS.size();
 	log << "Solving IPAMIR " << std::string(ipamir_signature()) << " with " << I.G.numberOfNodes()
 		<< " nodes" << std::endl;
 	if (!ipamir) {
@@ -18,50 +27,32 @@ void solveIPAMIR(Instance& I) {
 		}
 		ipamir_add_soft_lit(ipamir, I.node2ID[v], 1);
 	}
-#ifdef SAT_CACHE
-	std::vector<std::vector<int>> hclauses;
-	hclauses.reserve(I.G.numberOfNodes());
-#endif
 	for (auto v : I.G.nodes) {
 		if (I.is_dominated[v]) {
 			continue;
 		}
-#ifdef SAT_CACHE
-		hclauses.emplace_back();
-		hclauses.back().reserve(v->indeg() + 1);
-#endif
 		if (!I.is_subsumed[v]) {
 			ipamir_add_hard(ipamir, I.node2ID[v]);
-#ifdef SAT_CACHE
-			hclauses.back().push_back(I.node2ID[v]);
-#endif
 		}
 		auto add_neigh = [&](ogdf::adjEntry adj) {
 			auto w = adj->twinNode();
 			if (!adj->isSource() && !I.is_subsumed[w]) {
 				ipamir_add_hard(ipamir, I.node2ID[w]);
-#ifdef SAT_CACHE
-				hclauses.back().push_back(I.node2ID[w]);
-#endif
 			}
 			return true;
 		};
 		forAllInAdj(v, add_neigh);
 		ogdf::safeForEach(I.hidden_edges.adjEntries(v), add_neigh);
 		ipamir_add_hard(ipamir, 0);
-#ifdef SAT_CACHE
-		std::sort(hclauses.back().begin(), hclauses.back().end());
-#endif
-	}
-#ifdef SAT_CACHE
-	std::string filename;
-	if (try_load_solution(I, hclauses, filename)) {
-		return;
 	}
-	std::ofstream f(filename);
-#endif
 
+	ipamir_set_terminate(ipamir, &cancel,
+			[](void* state) { return (int)static_cast<Cancellation*>(state)->requested(); });
 	int result = ipamir_solve(ipamir);
+	if (result != 30 && cancel.requested()) {
+		ipamir_release(ipamir);
+		return false;
+	}
 	if (result != 30) {
 		ipamir_release(ipamir);
 		std::cerr << "result_status " << result << std::endl;
@@ -73,17 +64,96 @@ void solveIPAMIR(Instance& I) {
 	for (auto v : I.G.nodes) {
 		if (!I.is_subsumed[v]) {
 			if (ipamir_val_lit(ipamir, I.node2ID[v]) > 0) {
-				I.DS.insert(I.node2ID[v]);
+				DS.insert(I.node2ID[v]);
 				l << " " << I.node2ID[v];
-#ifdef SAT_CACHE
-				f << " " << I.node2ID[v];
-#endif
 			}
 		}
 	}
 	l << "\n";
-	log << "Updated DS (solved " << result << "): " << before << "+" << (I.DS.size() - before)
-		<< "=" << I.DS.size() << " (weight " << ipamir_val_obj(ipamir) << ")" << std::endl;
-	OGDF_ASSERT(ipamir_val_obj(ipamir) == I.DS.size() - before);
+	log << "IPAMIR solution size " << DS.size() << " (weight " << ipamir_val_obj(ipamir) << ")"
+		<< std::endl;
+	OGDF_ASSERT(ipamir_val_obj(ipamir) == DS.size());
 	ipamir_release(ipamir);
+	return true;
+}
+
+CutVertexSolver::CutVertexSolver(Instance& I, ogdf::node cv)
+	: I(I), cv(cv), var(I.G, 0) {
+	std::lock_guard<std::mutex> lock(ipamir_mutex);
+	ipamir = ipamir_init();
+	if (!ipamir) {
+		std::cerr << "solver not available" << std::endl;
+		exit(1);
+	}
+	int n = 0;
+	for (auto v : I.G.nodes) {
+		var[v] = ++n;
+		if (!I.is_subsumed[v]) {
+			ipamir_add_soft_lit(ipamir, var[v], 1);
+		}
+	}
+	// the clause of cv only holds if the activation literal is assumed
+	activation = n + 1;
+	for (auto v : I.G.nodes) {
+		if (I.is_dominated[v]) {
+			continue;
+		}
+		if (v == cv) {
+			ipamir_add_hard(ipamir, -activation);
+		}
+		if (!I.is_subsumed[v]) {
+			ipamir_add_hard(ipamir, var[v]);
+		}
+		auto add_neigh = [&](ogdf::adjEntry adj) {
+			auto w = adj->twinNode();
+			if (!adj->isSource() && !I.is_subsumed[w]) {
+				ipamir_add_hard(ipamir, var[w]);
+			}
+			return true;
+		};
+		forAllInAdj(v, add_neigh);
+		ogdf::safeForEach(I.hidden_edges.adjEntries(v), add_neigh);
+		ipamir_add_hard(ipamir, 0);
+	}
+}
+
+CutVertexSolver::~CutVertexSolver() {
+	std::lock_guard<std::mutex> lock(ipamir_mutex);
+	ipamir_release(ipamir);
+}
+
+bool CutVertexSolver::solve(CutVertexCase c, DominatingSet& DS, Cancellation& cancel) {
+	std::lock_guard<std::mutex> lock(ipamir_mutex);
+	if (cancel.requested()) {
+		return false;
+	}
+	int before = DS.size();
+	if (c != CutVertexCase::DOMINATED) {
+		ipamir_assume(ipamir, activation);
+	}
+	if (c == CutVertexCase::IN_DS) {
+		OGDF_ASSERT(!I.is_subsumed[cv]);
+		ipamir_assume(ipamir, var[cv]);
+	}
+	ipamir_set_terminate(ipamir, &cancel,
+			[](void* state) { return (int)static_cast<Cancellation*>(state)->requested(); });
+	int result = ipamir_solve(ipamir);
+	ipamir_set_terminate(ipamir, nullptr, nullptr);
+	if (result != 30 && cancel.requested()) {
+		return false;
+	}
+	if (result != 30) {
+		std::cerr << "result_status " << result << std::endl;
+		throw std::runtime_error(
+				"IPAMIR solver " + std::string(ipamir_signature()) + " didn't find optimal result!");
+	}
+	for (auto v : I.G.nodes) {
+		if (!I.is_subsumed[v] && ipamir_val_lit(ipamir, var[v]) > 0) {
+			DS.insert(I.node2ID[v]);
+		}
+	}
+	log << "IPAMIR solved cut vertex case " << (int)c << ": " << before << "+"
+		<< (DS.size() - before) << "=" << DS.size() << std::endl;
+	OGDF_ASSERT(ipamir_val_obj(ipamir) == DS.size() - before);
+	return true;
 }
@@ -0,0 +1,62 @@
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "ogdf_stats.hpp"
+
+static std::mutex stats_mutex;
+static std::map<std::pair<std::string, int>, RuleCounters> stats;
+
+void recordReductionStats(const char* rule, int depth, const RuleCounters& counters) {
+	std::lock_guard<std::mutex> lock(stats_mutex);
+	stats[{rule, depth}] += counters;
+}
+
+static void writeCounters(std::ostream& os, const RuleCounters& c) {
+	os << "\"calls\": " << c.calls << ", \"applied\": " << c.applied
+	   << ", \"seconds\": " << (double)c.nanos / 1e9 << ", \"nodes_removed\": " << c.nodes_removed
+	   << ", \"edges_removed\": " << c.edges_removed << ", \"ds_added\": " << c.ds_added;
+}
+
+static void writeJSON(std::ostream& os) {
+	// rule names are identifiers, so they need no escaping
+	std::map<std::string, RuleCounters> totals;
+	os << "{\n  \"rules\": [";
+	bool first = true;
+	for (const auto& [key, c] : stats) {
+		totals[key.first] += c;
+		os << (first ? "\n" : ",\n") << "    {\"rule\": \"" << key.first
+		   << "\", \"depth\": " << key.second << ", ";
+		writeCounters(os, c);
+		os << "}";
+		first = false;
+	}
+	os << "\n  ],\n  \"totals\": {";
+	first = true;
+	for (const auto& [rule, c] : totals) {
+		os << (first ? "\n" : ",\n") << "    \"" << rule << "\": {";
+		writeCounters(os, c);
+		os << "}";
+		first = false;
+	}
+	os << "\n  }\n}\n";
+}
+
+void writeReductionStats() {
+	const char* path = reductionStatsPath();
+	if (path == nullptr) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(stats_mutex);
+	if (std::string(path) == "-") {
+		writeJSON(std::cerr);
+		return;
+	}
+	std::ofstream out(path);
+	writeJSON(out);
+	if (!out) {
+		std::cerr << "Could not write reduction stats to " << path << std::endl;
+	}
+}
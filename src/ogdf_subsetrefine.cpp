@@ -1,5 +1,6 @@
 #include "ogdf_subsetrefine.hpp"
 
+#include <algorithm>
 #include <queue>
 
 // void bfsorder(ogdf::Graph G, std::list<ogdf::node>& order) {
@@ -28,196 +29,179 @@
 //     }
 // }
 
-size_t SubsetRefine::doRefinementReduction() {
-	std::vector<ogdf::node> refinebynodes;
-	ogdf::NodeArray<bool> isrefinedby(G, false);
-	for (auto u : G.nodes) {
-		if ((!instance.is_subsumed(u) && type == RefineType::Dominate)
-				|| (!instance.is_dominated(u) && type == RefineType::Subsume)) {
-			refinebynodes.push_back(u);
-		} else {
-			isrefinedby[u] = true;
+void SubsetRefine::read() {
+	auto& G = instance.G;
+	ogdf::NodeArray<int> id(G, -1);
+	nodes.reserve(G.numberOfNodes());
+	for (auto it = G.nodes.begin(); it != G.nodes.end();) {
+		auto v = *it;
+		++it;
+		if (instance.is_subsumed[v] && instance.is_dominated[v]) {
+			instance.safeDelete(v);
+			cntremoved++;
+			continue;
 		}
+		id[v] = nodes.size();
+		nodes.push_back(v);
+		subsumed.push_back(instance.is_subsumed[v]);
+		dominated.push_back(instance.is_dominated[v]);
 	}
 
-	while (needTouch.size() > 0) {
-		auto it = *needTouch.begin();
-		auto u = it.second;
-		if (it.first == 0) {
-			needTouch.erase(it);
-			continue;
-		}
-		while (isrefinedby[needRefineBy[u].back()]) {
-			needRefineBy[u].pop_back();
-			OGDF_ASSERT(!needRefineBy[u].empty());
+	// the only sweep over the adjacency, the candidate lists are the transposed target lists
+	size_t n = nodes.size();
+	out_begin.reserve(n + 1);
+	out_begin.push_back(0);
+	in_begin.assign(n + 1, 0);
+	for (auto v : nodes) {
+		instance.forAllCanDominate(v, [&](ogdf::node w) {
+			out_adj.push_back(id[w]);
+			in_begin[id[w] + 1]++;
+			return true;
+		});
+		out_begin.push_back(out_adj.size());
+	}
+	for (size_t t = 0; t < n; ++t) {
+		in_begin[t + 1] += in_begin[t];
+	}
+	in_adj.resize(out_adj.size());
+	needRefineByEnd.assign(in_begin.begin(), in_begin.end() - 1); // as fill positions here
+	for (size_t c = 0; c < n; ++c) {
+		for (size_t e = out_begin[c]; e < out_begin[c + 1]; ++e) {
+			in_adj[needRefineByEnd[out_adj[e]]++] = c;
 		}
-		auto v = needRefineBy[u].back();
-		refineByNode(v);
-		isrefinedby[v] = true;
 	}
+}
 
-	// log << "Partition refinement structure has " << refineG.numberOfNodes() << " nodes and "
-	// 	<< refineG.numberOfEdges() << " edges" << std::endl;
-	// log << "In total, the structure had " << cntedgesadded << " edges added." << std::endl;
-	for (auto bag : refineG.nodes) {
-		if (bag->indeg() > 0) {
-			auto vec = bagNodeVec[bag];
-			for (auto v : vec) {
-				doReduce(v);
-			}
-		} else if (bagNodeVec[bag].size() > 1) {
-			// reduce all but one
-			auto vec = bagNodeVec[bag];
-			bool someonestay = false;
-			for (size_t i = 0; i < vec.size(); i++) {
-				if (i < vec.size() - 1 || someonestay) {
-					someonestay |= !doReduce(vec[i]);
-				}
-			}
+void SubsetRefine::init(RefineType t) {
+	type = t;
+	size_t n = nodes.size();
+	// Subsume refines the nodes that are not subsumed by those that are not dominated, Dominate
+	// the other way round
+	const auto& reduced = type == RefineType::Subsume ? subsumed : dominated;
+	const auto& notRefiner = type == RefineType::Subsume ? dominated : subsumed;
+	needTouch.init(n);
+	bags.init(n);
+	bags.addBag();
+	needRefineByEnd.resize(n);
+	isrefinedby.assign(notRefiner.begin(), notRefiner.end());
+	for (int u = 0; u < (int)n; ++u) {
+		if (reduced[u]) {
+			continue;
+		}
+		bags.insert(u);
+		const int* begin = refinedByBegin(u);
+		const int* end = refinedByEnd(u);
+		needRefineByEnd[u] = end - begin;
+		size_t cnt = std::count_if(begin, end, [&](int r) { return !notRefiner[r]; });
+		if (cnt > 0) {
+			needTouch.insert(u, cnt);
 		}
 	}
-	return cntreduced;
 }
 
-void SubsetRefine::refineByNode(const ogdf::node& u) {
-	std::vector<ogdf::node> nodesToTouch;
-
+void SubsetRefine::doReduce(int u) {
+	auto v = nodes[u];
 	if (type == RefineType::Subsume) {
-		instance.forAllCanBeDominatedBy(u, [&](ogdf::node adj) {
-			if (bagof[adj] == nullptr) {
-				return true;
-			}
-			nodesToTouch.push_back(adj);
-			return true;
-		});
+		instance.markSubsumed(v);
+		subsumed[u] = 1;
+		cntsubsumed++;
 	} else {
-		instance.forAllCanDominate(u, [&](ogdf::node adj) {
-			if (bagof[adj] == nullptr) {
-				return true;
-			}
-			nodesToTouch.push_back(adj);
-			return true;
-		});
+		instance.markDominated(v, false);
+		dominated[u] = 1;
+		cntdominated++;
 	}
-
-	for (auto u : nodesToTouch) {
-		needTouch.erase({needRefineBySize[u], u});
-		needRefineBySize[u]--;
-		if (needRefineBySize[u] > 0) {
-			needTouch.insert({needRefineBySize[u], u});
-		}
+	if (subsumed[u] && dominated[u]) {
+		instance.safeDelete(v);
+		nodes[u] = nullptr;
+		cntremoved++;
+	}
+	bags.remove(u);
+	if (needTouch.contains(u)) {
+		needTouch.remove(u);
 	}
+}
 
-	// move vertices into new bags
-	std::vector<ogdf::node> touchedbags;
-	for (auto v : nodesToTouch) {
-		cnttouched[v]++;
-		auto bag = bagof[v];
-		ogdf::node newbag;
-		if (refinedBag[bag] == nullptr) {
-			newbag = refineG.newNode();
-			touchedbags.push_back(bag);
-			refinedBag[bag] = newbag;
-		} else {
-			newbag = refinedBag[bag];
+void SubsetRefine::run() {
+	read();
+	init(RefineType::Subsume);
+	doRefinementReduction();
+	init(RefineType::Dominate);
+	doRefinementReduction();
+}
+
+void SubsetRefine::doRefinementReduction() {
+	while (!needTouch.empty()) {
+		auto u = needTouch.min();
+		const int* refinedBy = refinedByBegin(u);
+		size_t& end = needRefineByEnd[u];
+		while (isrefinedby[refinedBy[end - 1]]) {
+			--end;
+			OGDF_ASSERT(end > 0);
 		}
-		// swap and pop from old bag
-		auto& vec = bagNodeVec[bag];
-		auto oldindex = vecIndex[v];
-		vecIndex[vec[vec.size() - 1]] = oldindex;
-		std::swap(vec[oldindex], vec[vec.size() - 1]);
-		vec.pop_back();
-		// insert into new bag
-		auto& newvec = bagNodeVec[newbag];
-		bagof[v] = newbag;
-		vecIndex[v] = newvec.size();
-		newvec.push_back(v);
+		auto v = refinedBy[end - 1];
+		refineByNode(v);
+		isrefinedby[v] = 1;
 	}
 
-	// update bag adjacencies
-	for (auto bag : touchedbags) {
-		auto newbag = refinedBag[bag];
+	// the decisions are taken before reducing, as the reduced bags are removed from the relations
+	std::vector<std::pair<int, bool>> decisions; // bag -> whether all its nodes are reduced
+	bags.forEachBag([&](int bag) {
 		if (type == RefineType::Subsume) {
-			// the refined bag has vertices with superset outedges
-			refineG.newEdge(newbag, ogdf::Direction::before, bag, ogdf::Direction::after);
-			// everything that was subsumed by old bag is also subsumed by new bag, but also the refined bags
-			cntedgesadded++;
-
-			forAllOutAdj(bag, [&](ogdf::adjEntry adj) {
-				refineG.newEdge(newbag, ogdf::Direction::before, adj->twinNode(),
-						ogdf::Direction::after);
-				cntedgesadded++;
-				if (refinedBag[adj->twinNode()] != nullptr) {
-					refineG.newEdge(newbag, ogdf::Direction::before, refinedBag[adj->twinNode()],
-							ogdf::Direction::after);
-					cntedgesadded++;
-				}
-				return true;
-			});
+			decisions.emplace_back(bag, bags.hasSuperset(bag));
 		} else {
-			// the refined bag has vertices with superset inedges
-			refineG.newEdge(bag, ogdf::Direction::before, newbag, ogdf::Direction::after);
-			cntedgesadded++;
-			forAllInAdj(bag, [&](ogdf::adjEntry adj) {
-				refineG.newEdge(adj->twinNode(), ogdf::Direction::before, newbag,
-						ogdf::Direction::after);
-				cntedgesadded++;
-				if (refinedBag[adj->twinNode()] != nullptr) {
-					refineG.newEdge(refinedBag[adj->twinNode()], ogdf::Direction::before, newbag,
-							ogdf::Direction::after);
-					cntedgesadded++;
-				}
-				return true;
-			});
+			decisions.emplace_back(bag, bags.hasSubset(bag));
+		}
+	});
+	for (auto [bag, all] : decisions) {
+		// otherwise reduce all but one
+		while (bags.size(bag) > (all ? 0 : 1)) {
+			doReduce(bags.back(bag));
 		}
 	}
+}
 
-	// remove bags without nodes in it and reset refinedBag
-	for (auto it = touchedbags.begin(); it != touchedbags.end();) {
-		auto bag = *it;
+void SubsetRefine::refineByNode(int u) {
+	nodesToTouch.clear();
+	for (const int* it = touchesBegin(u); it != touchesEnd(u); ++it) {
+		if (bags.bagOf(*it) != PartitionRefinement::NONE) {
+			nodesToTouch.push_back(*it);
+		}
+	}
 
-		++it;
-		refinedBag[bag] = nullptr;
-		if (bagNodeVec[bag].size() == 0) {
-			refineG.delNode(bag);
+	for (auto u : nodesToTouch) {
+		needTouch.decrease(u);
+		if (needTouch.key(u) == 0 && needTouch.contains(u)) {
+			needTouch.remove(u);
 		}
 	}
 
+	// move vertices into new bags, which have superset outedges (Subsume) or inedges (Dominate)
 	for (auto v : nodesToTouch) {
-		if (needRefineBySize[v] == 0) {
-			if (type == RefineType::Subsume
-					&& (bagof[v]->indeg() > 0 || bagNodeVec[bagof[v]].size() > 1)) {
-				// v will be subsumed in the end either way by incoming edges or by someone in the bag
-				auto& vec = bagNodeVec[bagof[v]];
-				auto bag = bagof[v];
-				doReduce(v);
+		bags.touch(v);
+	}
+	bags.finishRound();
 
-				if (vec.size() == 0) {
-					refineG.delNode(bag);
-				}
+	for (auto v : nodesToTouch) {
+		if (needTouch.key(v) == 0) {
+			auto bag = bags.bagOf(v);
+			if (type == RefineType::Subsume && bag != PartitionRefinement::NONE
+					&& (bags.hasSuperset(bag) || bags.size(bag) > 1)) {
+				// v will be subsumed in the end either way, by a superset bag or by its bag mates
+				doReduce(v);
 			} else if (type == RefineType::Dominate) {
-				// the subset relations for outedges will not change anymore so we can already dominate all outedges and nodes in the bag
-				if (bagof[v] == nullptr) {
+				// the inedges of v will not change anymore, so we can already dominate the superset
+				// bags and the rest of its bag
+				if (bag == PartitionRefinement::NONE) {
 					continue;
 				}
-				forAllOutAdj(bagof[v], [&](ogdf::adjEntry adj) {
-					for (auto w : std::vector<ogdf::node>(bagNodeVec[adj->twinNode()].begin(),
-								 bagNodeVec[adj->twinNode()].end())) {
-						doReduce(w);
+				bags.forEachSuperset(bag, [&](int sup) {
+					while (bags.size(sup) > 0) {
+						doReduce(bags.back(sup));
 					}
-					if (bagNodeVec[adj->twinNode()].size() == 0) {
-						refineG.delNode(adj->twinNode());
-					}
-					return true;
 				});
-				for (auto w : std::vector<ogdf::node>(bagNodeVec[bagof[v]].begin(),
-							 bagNodeVec[bagof[v]].end())) {
-					if (w != v) {
-						doReduce(w);
-					}
-				}
-				if (bagNodeVec[bagof[v]].size() == 0) {
-					refineG.delNode(bagof[v]);
+				bags.moveToFront(v);
+				while (bags.size(bag) > 1) {
+					doReduce(bags.back(bag));
 				}
 			}
 		}
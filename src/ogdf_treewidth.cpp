@@ -1,27 +1,113 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
 #include "ogdf_treewidth.h"
 
-std::unique_ptr<htd::LibraryInstance> manager(htd::createManagementInstance(htd::Id::FIRST));
+// minimum number of signatures per task when a single bag is split across threads
+constexpr size_t DP_PARALLEL_GRAIN = 1 << 14;
 
-void ReductionTreeDecomposition::computeDecomposition() {
-	std::srand(0);
+// upper bound for the three (signature x kappa) arrays of an array join
+constexpr size_t JOIN_ARRAY_MAX_BYTES = 256 << 20;
+
+// Memory for the DP tables of all components solved at the same time, can be set in MiB by the
+// environment variable PACE_DP_MEMORY_MB.
+static size_t dpMemoryBudget() {
+	static const size_t budget = [] {
+		const char* env = std::getenv("PACE_DP_MEMORY_MB");
+		if (env != nullptr && std::atoll(env) > 0) {
+			return (size_t)std::atoll(env) << 20;
+		}
+		return (size_t)2048 << 20;
+	}();
+	return budget;
+}
+
+static std::atomic<size_t> dp_memory_in_use {0};
+
+static bool reserveDPMemory(size_t bytes) {
+	size_t cur = dp_memory_in_use.load();
+	do {
+		if (cur + bytes > dpMemoryBudget()) {
+			return false;
+		}
+	} while (!dp_memory_in_use.compare_exchange_weak(cur, cur + bytes));
+	return true;
+}
+
+// worst case size of the table of a bag with k vertices, while it is computed or once it is frozen
+static size_t worstTableBytes(size_t k, bool frozen) {
+	if (k >= PackedSig::MAX_LEN) {
+		return std::numeric_limits<size_t>::max() / 4;
+	}
+	if (k <= DPTable::DENSE_MAX_BAG) {
+		return POW3[k] * (sizeof(DPTable::Value) + sizeof(uint32_t));
+	}
+	if (frozen) {
+		return POW3[k] * (2 * sizeof(DPTable::Sig) + sizeof(DPTable::Value));
+	}
+	return POW3[k] * DPTable::SPARSE_ENTRY_COST * (sizeof(DPTable::Value) + sizeof(uint32_t));
+}
 
-	manager->reset();
+// Largest bag for which the DP is worth trying, as a decomposition of this width will not get
+// rejected by fitsDPMemory().
+static size_t dpMaxBagSize() {
+	size_t k = 1;
+	while (3 * worstTableBytes(k + 1, false) + JOIN_ARRAY_MAX_BYTES <= dpMemoryBudget()) {
+		k++;
+	}
+	return k;
+}
+
+// htd draws its random choices from std::rand(). Several heuristics and components compute
+// decompositions at once, so the shared C generator is replaced by one per thread, which the
+// portfolio seeds per heuristic. This keeps every heuristic deterministic and independent of what
+// runs concurrently.
+static thread_local uint64_t rand_state = 1;
+
+extern "C" void srand(unsigned int seed) noexcept { rand_state = seed; }
+
+extern "C" int rand() noexcept {
+	rand_state = rand_state * 6364136223846793005ull + 1442695040888963407ull;
+	return (int)(rand_state >> 33) & RAND_MAX;
+}
+
+// time for the decomposition heuristics, growing with the instance
+static std::chrono::milliseconds decompositionTimeBudget(size_t n, size_t m) {
+	return std::chrono::milliseconds(std::clamp<size_t>(100 + (n + m) / 50, 100, 10000));
+}
+
+struct DecompositionHeuristic {
+	const char* name;
+	std::function<htd::IOrderingAlgorithm*(const htd::LibraryInstance*)> ordering;
+	size_t iterations;
+	size_t nonImprovementLimit;
+};
 
-	// Create a new graph instance which can handle (multi-)hyperedges.
-	graph = manager->graphFactory().createInstance(); // Use Multigraph! Graph checks if parallel edges, which is super slow!
-	graph->addVertices(G.numberOfNodes());
+// the portfolio, in order of preference, the first paceThreads() ones are run
+static const std::vector<DecompositionHeuristic> heuristics = {
+		{"min-fill", [](auto m) { return new htd::MinFillOrderingAlgorithm(m); }, 10, 3},
+		{"min-degree", [](auto m) { return new htd::MinDegreeOrderingAlgorithm(m); }, 10, 3},
+		{"mcs", [](auto m) { return new htd::MaximumCardinalitySearchOrderingAlgorithm(m); }, 10,
+				3},
+		{"min-fill-restarts", [](auto m) { return new htd::MinFillOrderingAlgorithm(m); }, 100,
+				30},
+};
+
+void ReductionTreeDecomposition::computeDecomposition() {
+	std::vector<std::pair<htd::vertex_t, htd::vertex_t>> edges;
 	size_t cnt = 0;
 	for (ogdf::node v : G.nodes) {
 		nodeid[v] = ++cnt;
 		idnode[cnt] = v;
 	}
 	ogdf::NodeSet added(G);
-	size_t i = 0;
 	for (auto u : G.nodes) {
 		forAllOutAdj(u, [&](ogdf::adjEntry adj) {
 			auto v = adj->twinNode();
 			if (u < v) {
-				graph->addEdgeWithoutCheck(nodeid[u], nodeid[v]);
+				edges.emplace_back(nodeid[u], nodeid[v]);
 				added.insert(v);
 			}
 			return true;
@@ -29,154 +115,150 @@ void ReductionTreeDecomposition::computeDecomposition() {
 		forAllInAdj(u, [&](ogdf::adjEntry adj) {
 			auto v = adj->twinNode();
 			if (u < v && !added.isMember(v)) {
-				graph->addEdgeWithoutCheck(nodeid[u], nodeid[v]);
+				edges.emplace_back(nodeid[u], nodeid[v]);
 			}
 			return true;
 		});
 		added.clear();
 	}
 
-
-	FitnessFunction fitnessFunction;
-	htd::TreeDecompositionOptimizationOperation* operation =
-			new htd::TreeDecompositionOptimizationOperation(manager.get(), fitnessFunction.clone());
-	operation->setManagementInstance(manager.get());
-	operation->setVertexSelectionStrategy(new htd::RandomVertexSelectionStrategy(3));
-	operation->addManipulationOperation(
-			new htd::NormalizationOperation(manager.get(), false, false, true, true));
-	manager->orderingAlgorithmFactory().setConstructionTemplate(
-			new htd::MinFillOrderingAlgorithm(manager.get()));
-	htd::ITreeDecompositionAlgorithm* baseAlgorithm =
-			manager->treeDecompositionAlgorithmFactory().createInstance();
-	baseAlgorithm->addManipulationOperation(operation);
-	htd::IterativeImprovementTreeDecompositionAlgorithm algorithm(manager.get(), baseAlgorithm,
-			fitnessFunction.clone());
-	algorithm.setIterationCount(10);
-	algorithm.setNonImprovementLimit(3);
-	manager->setTimeout(std::chrono::system_clock::now() + std::chrono::seconds(1));
-
-	std::size_t optimalBagSize = (std::size_t)-1;
-	decomposition = algorithm.computeDecomposition(*graph,
-			[&](const htd::IMultiHypergraph& graph, const htd::ITreeDecomposition& decomposition,
-					const htd::FitnessEvaluation& fitness) {
-				// Disable warnings concerning unused variables.
-				HTD_UNUSED(graph)
-				HTD_UNUSED(decomposition)
-
-				std::size_t bagSize = -fitness.at(0);
-
-				/**
-				 *  After each improvement we print the current optimal
-				 *  width + 1 and the time when the decomposition was found.
-				 */
-				if (bagSize < optimalBagSize) {
-					// optimalBagSize = bagSize;
-
-					// std::chrono::milliseconds::rep msSinceEpoch =
-					// 		std::chrono::duration_cast<std::chrono::milliseconds>(
-					// 				std::chrono::system_clock::now().time_since_epoch())
-					// 				.count();
-
-					// std::cout << "c status " << optimalBagSize << " " << msSinceEpoch << std::endl;
-				}
-			});
-
-	if (decomposition != nullptr) {
-		if (!manager->isTerminated() || algorithm.isSafelyInterruptible()) {
-			// Print the height of the decomposition to stdout.
-			// std::cout << decomposition->height() << std::endl;
-
-			// Print the size of the largest bag of the decomposition to stdout.
-			// std::cout << decomposition->maximumBagSize() << std::endl;
-			treewidth = decomposition->maximumBagSize();
-		} else {
-			delete decomposition;
-			decomposition = nullptr;
-		}
-	} else {
-		log << "Interrupted, no decomposition found!" << std::endl;
+	// the cheap native elimination orderings first
+	size_t maxbag = dpMaxBagSize();
+	std::vector<std::vector<int>> neighbours(G.numberOfNodes());
+	for (auto [u, v] : edges) {
+		neighbours[u - 1].push_back(v - 1);
+		neighbours[v - 1].push_back(u - 1);
 	}
-}
-
-TW_SIGNATURE_TYPE fromSigWithInsert(const std::vector<TW_SIGNATURE_TYPE>& sig, const size_t index,
-		TW_SIGNATURE_TYPE status) {
-	TW_SIGNATURE_TYPE id = 0;
-	if (index == sig.size()) {
-		id = status;
+	EliminationDecomposition native(std::move(neighbours));
+	size_t lower = native.lowerBound();
+	if (lower + 1 > maxbag) {
+		log << "Treewidth is at least " << lower << ", too large for the DP" << std::endl;
+		return;
 	}
-	for (int i = sig.size() - 1; i >= 0; i--) {
-		id *= 3;
-		id += sig[i];
-		if (i == index) {
-			id *= 3;
-			id += status;
-		}
+	bool nativefound = native.compute(EliminationDecomposition::Heuristic::MIN_FILL, maxbag);
+	nativefound |= native.compute(EliminationDecomposition::Heuristic::MIN_DEGREE,
+			nativefound ? native.width - 1 : maxbag);
+	if (nativefound) {
+		collectBags(native);
+		treewidth = native.width;
+		log << "Decomposition from elimination ordering" << std::endl;
+		return;
 	}
-	return id;
-}
 
-TW_SIGNATURE_TYPE fromSigVec(const std::vector<TW_SIGNATURE_TYPE>& sig) {
-	TW_SIGNATURE_TYPE id = 0;
-	for (int i = sig.size() - 1; i >= 0; i--) {
-		id *= 3;
-		id += sig[i];
-	}
-	return id;
-}
+	// All heuristics run until the deadline, unless one of them finds a decomposition that is
+	// good enough for the DP, which terminates all of them. The first heuristic gets the full time
+	// even if it starts late.
+	size_t candidates = std::min<size_t>(heuristics.size(), paceThreads());
+	auto budget = decompositionTimeBudget(G.numberOfNodes(), G.numberOfEdges());
+	auto deadline = std::chrono::system_clock::now() + budget;
+	size_t goodenough = dpMaxBagSize();
+	std::atomic<bool> found {false};
+	// guards managers, so that a heuristic that starts while found is set does not miss it
+	std::mutex managers_mutex;
+	auto terminateAll = [&] {
+		std::lock_guard<std::mutex> lock(managers_mutex);
+		for (auto& m : managers) {
+			if (m) {
+				m->terminate();
+			}
+		}
+	};
+	managers.clear();
+	managers.resize(candidates);
+	std::vector<htd::IMutableGraph*> graphs(candidates, nullptr);
+	std::vector<htd::ITreeDecomposition*> results(candidates, nullptr);
+	TaskGroup group;
+	for (size_t i = 0; i < candidates; i++) {
+		group.run([&, i] {
+			auto start = std::chrono::system_clock::now();
+			htd::LibraryInstance* manager;
+			{
+				std::lock_guard<std::mutex> lock(managers_mutex);
+				if (found || (i > 0 && start >= deadline)) {
+					return;
+				}
+				// htd keeps the timeout and the algorithm templates in the management instance
+				managers[i].reset(htd::createManagementInstance(htd::Id::FIRST + i));
+				manager = managers[i].get();
+			}
+			std::srand(i + 1);
 
-std::vector<TW_SIGNATURE_TYPE> toSigVec(TW_SIGNATURE_TYPE id, size_t size) {
-	std::vector<TW_SIGNATURE_TYPE> sig(size);
-	for (size_t i = 0; i < size; i++) {
-		sig[i] = id % 3;
-		id /= 3;
-	}
-	return sig;
-}
+			// Create a new graph instance which can handle (multi-)hyperedges.
+			graphs[i] = manager->graphFactory().createInstance(); // Use Multigraph! Graph checks if parallel edges, which is super slow!
+			graphs[i]->addVertices(G.numberOfNodes());
+			for (auto [u, v] : edges) {
+				graphs[i]->addEdgeWithoutCheck(u, v);
+			}
 
-TW_SIGNATURE_TYPE sigAt(TW_SIGNATURE_TYPE id, size_t i) {
-	return (id / (size_t)pow((size_t)3, i)) % 3; // TODO: maybe precompute powers
-}
+			FitnessFunction fitnessFunction;
+			htd::TreeDecompositionOptimizationOperation* operation =
+					new htd::TreeDecompositionOptimizationOperation(manager,
+							fitnessFunction.clone());
+			operation->setManagementInstance(manager);
+			operation->setVertexSelectionStrategy(new htd::RandomVertexSelectionStrategy(3));
+			operation->addManipulationOperation(
+					new htd::NormalizationOperation(manager, false, false, true, true));
+			manager->orderingAlgorithmFactory().setConstructionTemplate(
+					heuristics[i].ordering(manager));
+			htd::ITreeDecompositionAlgorithm* baseAlgorithm =
+					manager->treeDecompositionAlgorithmFactory().createInstance();
+			baseAlgorithm->addManipulationOperation(operation);
+			htd::IterativeImprovementTreeDecompositionAlgorithm algorithm(manager, baseAlgorithm,
+					fitnessFunction.clone());
+			algorithm.setIterationCount(heuristics[i].iterations);
+			algorithm.setNonImprovementLimit(heuristics[i].nonImprovementLimit);
+			manager->setTimeout(i == 0 ? std::max(deadline, start + budget) : deadline);
 
-TW_SIGNATURE_TYPE sigAtSet(TW_SIGNATURE_TYPE id, size_t i, TW_SIGNATURE_TYPE status) {
-	return status * pow((size_t)3, i) + id % (size_t)pow((size_t)3, i)
-			+ (id / (size_t)pow((size_t)3, i + 1)) * (size_t)pow((size_t)3, i + 1); // bits after index
-}
+			results[i] = algorithm.computeDecomposition(*graphs[i],
+					[&](const htd::IMultiHypergraph& graph,
+							const htd::ITreeDecomposition& decomposition,
+							const htd::FitnessEvaluation& fitness) {
+						// Disable warnings concerning unused variables.
+						HTD_UNUSED(graph)
+						HTD_UNUSED(decomposition)
 
-TW_SIGNATURE_TYPE stripSigAt(TW_SIGNATURE_TYPE id, size_t i) {
-	return id % (size_t)pow((size_t)3, i) + // bits before index
-			+(id / (size_t)pow((size_t)3, i + 1)) * (size_t)pow((size_t)3, i); // bits after index
-}
+						std::size_t bagSize = -fitness.at(0);
+						if (bagSize <= goodenough && !found.exchange(true)) {
+							terminateAll();
+						}
+					});
+			if (results[i] != nullptr && manager->isTerminated()
+					&& !algorithm.isSafelyInterruptible()) {
+				delete results[i];
+				results[i] = nullptr;
+			}
+		});
+	}
+	group.wait();
 
-size_t cntUndominated(TW_SIGNATURE_TYPE id, size_t vecsize) {
-	size_t cnt = 0;
-	for (size_t i = 0; i < vecsize; i++) {
-		if (id % 3 == TW_WAITING) {
-			cnt++;
+	// smallest width, then height, then the order of the portfolio
+	size_t best = candidates;
+	for (size_t i = 0; i < candidates; i++) {
+		if (results[i] == nullptr) {
+			continue;
+		}
+		if (best == candidates
+				|| std::make_pair(results[i]->maximumBagSize(), results[i]->height())
+						< std::make_pair(
+								results[best]->maximumBagSize(), results[best]->height())) {
+			best = i;
 		}
-		id /= 3;
 	}
-	return cnt;
-}
-
-size_t cntInDs(TW_SIGNATURE_TYPE id) {
-	size_t cnt = 0;
-	while (id > 0) {
-		if (id % 3 == TW_INDS) {
-			cnt++;
+	for (size_t i = 0; i < candidates; i++) {
+		if (i != best) {
+			delete results[i];
+			delete graphs[i];
 		}
-		id /= 3;
 	}
-	return cnt;
-}
-
-inline void updateTable(std::unordered_map<TW_SIGNATURE_TYPE,
-								std::tuple<size_t, TW_SIGNATURE_TYPE, TW_SIGNATURE_TYPE>>& DP,
-		TW_SIGNATURE_TYPE sig, size_t val, TW_SIGNATURE_TYPE sig2, TW_SIGNATURE_TYPE sig3) {
-	if (DP.find(sig) == DP.end()) {
-		DP[sig] = {val, sig2, sig3};
-	} else if (std::get<0>(DP[sig]) > val) {
-		DP[sig] = {val, sig2, sig3};
+	if (best == candidates) {
+		log << "Interrupted, no decomposition found!" << std::endl;
+		return;
 	}
+	decomposition = results[best];
+	graph = graphs[best];
+	treewidth = decomposition->maximumBagSize();
+	log << "Decomposition from " << heuristics[best].name << " heuristic" << std::endl;
+	collectBags();
 }
 
 void ReductionTreeDecomposition::handleLeaf(htd::vertex_t curbag) {
@@ -185,42 +267,76 @@ void ReductionTreeDecomposition::handleLeaf(htd::vertex_t curbag) {
 	ogdf::node voriginal = bag_nodes[curbag][0];
 	OGDF_ASSERT(I.is_subsumed.graphOf() == I.is_dominated.graphOf());
 	OGDF_ASSERT(I.is_subsumed.graphOf() == voriginal->graphOf());
+	if (!initTable(curbag, 1, 2)) {
+		return;
+	}
 	if (!I.is_dominated[voriginal]) {
-		DP[curbag][TW_WAITING] = {0, 0, 0};
+		DP[curbag].update(TW_WAITING, 0, 0);
 		// DPCNT[curbag][{TW_WAITING, 0}] = 1;
 	} else {
-		DP[curbag][TW_DOMINATED] = {0, 0, 0};
+		DP[curbag].update(TW_DOMINATED, 0, 0);
 		// DPCNT[curbag][{TW_DOMINATED, 0}] = 1;
 	}
 	if (!I.is_subsumed[voriginal]) {
 		// DPCNT[curbag][{TW_INDS, 1}] = 0;
-		DP[curbag][TW_INDS] = {1, 0, 0};
+		DP[curbag].update(TW_INDS, 1, 0);
 	}
 	minkappa[curbag] = 0;
 }
 
 void ReductionTreeDecomposition::handleForgetNode(htd::vertex_t curbag) {
 	// FORGET NODE
-	OGDF_ASSERT(decomposition->children(curbag).size() == 1);
-	auto bagchild = decomposition->childAtPosition(curbag, 0);
+	OGDF_ASSERT(bags[curbag].children.size() == 1);
+	auto bagchild = bags[curbag].children[0];
 	OGDF_ASSERT(bag_nodes[curbag].size() + 1 == bag_nodes[bagchild].size());
-	OGDF_ASSERT(decomposition->forgottenVertices(curbag).size() == 1);
-	auto forgotten = *decomposition->forgottenVertices(curbag).begin();
-	ogdf::node forgottenvertex = idnode[forgotten];
+	ogdf::node forgottenvertex = bags[curbag].vertex;
 	size_t forgottenindex =
 			lower_bound(bag_nodes[bagchild].begin(), bag_nodes[bagchild].end(), forgottenvertex)
 			- bag_nodes[bagchild].begin();
 	OGDF_ASSERT(forgottenindex < bag_nodes[bagchild].size());
 	OGDF_ASSERT(bag_nodes[bagchild][forgottenindex] == forgottenvertex);
 
-	for (auto& [sig, val] : DP[bagchild]) {
-		if (sigAt(sig, forgottenindex) != TW_WAITING) {
-			// forgetting vertex is fine because it is already dominated
-			TW_SIGNATURE_TYPE newsig = stripSigAt(sig, forgottenindex);
-			updateTable(DP[curbag], newsig, std::get<0>(val), sig, 0);
-			minkappa[curbag] = std::min(minkappa[curbag], std::get<0>(val));
-		}
+	const DPTable& child = DP[bagchild];
+	if (!initTable(curbag, bag_nodes[curbag].size(), child.size())) {
+		return;
+	}
+	DPTable& table = DP[curbag];
+	if (child.isDense() && table.isDense()) {
+		// Every signature has two sources, with the forgotten vertex dominated or in the DS.
+		// Taking the first one on ties gives the same table as the ascending scan below.
+		std::mutex mutex;
+		parallelRanges(POW3[bag_nodes[curbag].size()], DP_PARALLEL_GRAIN,
+				[&](size_t begin, size_t end) {
+					size_t entries = 0, kappa = std::numeric_limits<size_t>::max();
+					for (TW_SIGNATURE_TYPE sig = begin; sig < end; sig++) {
+						auto dom = insertSigAt(sig, forgottenindex, TW_DOMINATED);
+						auto inds = insertSigAt(sig, forgottenindex, TW_INDS);
+						auto val = child.value(dom), valinds = child.value(inds);
+						if (valinds < val) {
+							val = valinds;
+							dom = inds;
+						}
+						if (val != DPTable::NONE) {
+							table.fill(sig, val, dom);
+							kappa = std::min<size_t>(kappa, val);
+							entries++;
+						}
+					}
+					std::lock_guard<std::mutex> lock(mutex);
+					table.addFilled(entries);
+					minkappa[curbag] = std::min(minkappa[curbag], kappa);
+				});
+	} else {
+		child.forEach([&](TW_SIGNATURE_TYPE sig, size_t val, TW_SIGNATURE_TYPE) {
+			if (sigAt(sig, forgottenindex) != TW_WAITING) {
+				// forgetting vertex is fine because it is already dominated
+				TW_SIGNATURE_TYPE newsig = stripSigAt(sig, forgottenindex);
+				table.update(newsig, val, sig);
+				minkappa[curbag] = std::min(minkappa[curbag], val);
+			}
+		});
 	}
+	table.compact();
 
 	// for (auto& [sig_cnt, val] : DPCNT[bagchild]) {
 	// 	if (sigAt(sig_cnt.first, forgottenindex) != TW_WAITING) {
@@ -232,73 +348,133 @@ void ReductionTreeDecomposition::handleForgetNode(htd::vertex_t curbag) {
 }
 
 void ReductionTreeDecomposition::handleIntroduceNode(htd::vertex_t curbag) {
-	OGDF_ASSERT(decomposition->children(curbag).size() == 1);
-	auto bagchild = decomposition->childAtPosition(curbag, 0);
+	OGDF_ASSERT(bags[curbag].children.size() == 1);
+	auto bagchild = bags[curbag].children[0];
 	OGDF_ASSERT(bag_nodes[curbag].size() == bag_nodes[bagchild].size() + 1);
-	OGDF_ASSERT(decomposition->introducedVertices(curbag).size() == 1);
-	auto introduced = *decomposition->introducedVertices(curbag).begin();
 	minkappa[curbag] = minkappa[bagchild];
-	ogdf::node introducedvertex = idnode[introduced];
-	for (auto u : bag_nodes[bagchild]) {
-		currBagNodes.insert(u);
-	}
+	ogdf::node introducedvertex = bags[curbag].vertex;
 	size_t introducedindex =
 			lower_bound(bag_nodes[curbag].begin(), bag_nodes[curbag].end(), introducedvertex)
 			- bag_nodes[curbag].begin();
 	OGDF_ASSERT(bag_nodes[curbag][introducedindex] == introducedvertex);
-	for (size_t i = 0; i < bag_nodes[bagchild].size(); i++) {
-		currSigIndex[bag_nodes[bagchild][i]] = i;
-	}
-	for (auto& [sig, val] : DP[bagchild]) {
-		auto sigvec = toSigVec(sig, bag_nodes[bagchild].size());
+	const auto& childnodes = bag_nodes[bagchild];
+	size_t childlen = childnodes.size();
+	OGDF_ASSERT(childlen < PackedSig::MAX_LEN);
+	// the in- and out-neighbours of the introduced vertex within the child bag
+	uint64_t in_bag = 0, out_bag = 0;
+	auto inChildBag = [&](ogdf::node v, uint64_t& mask) {
+		auto it = std::lower_bound(childnodes.begin(), childnodes.end(), v);
+		if (it != childnodes.end() && *it == v) {
+			mask |= PackedSig::vertex(it - childnodes.begin());
+		}
+		return true;
+	};
+	forAllInAdj(introducedvertex,
+			[&](ogdf::adjEntry adj) { return inChildBag(adj->twinNode(), in_bag); });
+	forAllOutAdj(introducedvertex,
+			[&](ogdf::adjEntry adj) { return inChildBag(adj->twinNode(), out_bag); });
+	bool dominated = I.is_dominated[introducedvertex];
+	bool subsumed = I.is_subsumed[introducedvertex];
 
-		if (I.is_dominated[introducedvertex]) {
-			auto newsig = fromSigWithInsert(sigvec, introducedindex, TW_DOMINATED);
-			updateTable(DP[curbag], newsig, std::get<0>(val), sig, 0);
-		} else {
-			auto newsig = fromSigWithInsert(sigvec, introducedindex, TW_WAITING);
-			updateTable(DP[curbag], newsig, std::get<0>(val), sig,
-					0); // need this for fast join nodes!
-			bool anyininds = false;
-			forAllInAdj(introducedvertex, [&](ogdf::adjEntry adj) {
-				auto v = adj->twinNode();
-				if (currBagNodes.isMember(v) && sigvec[currSigIndex[v]] == TW_INDS) {
-					anyininds = true;
-					return false;
+	const DPTable& child = DP[bagchild];
+	if (!initTable(curbag, bag_nodes[curbag].size(), 2 * child.size())) {
+		return;
+	}
+	DPTable& table = DP[curbag];
+	if (child.isDense() && table.isDense()) {
+		// The waiting and dominated entries have a single source each, so disjoint ranges of the
+		// child can be copied concurrently. The DS entries are gathered from their sources in
+		// ascending order, which keeps the first one on ties like the scan below.
+		std::mutex mutex;
+		parallelRanges(POW3[childlen], DP_PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+			size_t entries = 0;
+			for (TW_SIGNATURE_TYPE sig = begin; sig < end; sig++) {
+				auto val = child.value(sig);
+				if (val == DPTable::NONE) {
+					continue;
+				}
+				if (dominated || PackedSig::fromSig(sig, childlen).anyInDs(in_bag)) {
+					table.fill(insertSigAt(sig, introducedindex, TW_DOMINATED), val, sig);
+					entries++;
+				}
+				if (!dominated) {
+					table.fill(insertSigAt(sig, introducedindex, TW_WAITING), val, sig);
+					entries++;
 				}
-				return true;
-			});
-			if (anyininds) {
-				auto newsig = fromSigWithInsert(sigvec, introducedindex, TW_DOMINATED);
-				updateTable(DP[curbag], newsig, std::get<0>(val), sig, 0);
 			}
-		}
-
-		if (!I.is_subsumed[introducedvertex]) {
-			forAllOutAdj(introducedvertex, [&](ogdf::adjEntry adj) {
-				auto v = adj->twinNode();
-				if (currBagNodes.isMember(v) && sigvec[currSigIndex[v]] == TW_WAITING) {
-					sigvec[currSigIndex[v]] = TW_DOMINATED;
+			std::lock_guard<std::mutex> lock(mutex);
+			table.addFilled(entries);
+		});
+		if (!subsumed) {
+			parallelRanges(POW3[childlen], DP_PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+				size_t entries = 0;
+				std::vector<size_t> choice;
+				for (TW_SIGNATURE_TYPE sig = begin; sig < end; sig++) {
+					// sources have the same digits, except that the dominated out-neighbours
+					// may also be waiting
+					auto packed = PackedSig::fromSig(sig, childlen);
+					if (packed.with(TW_WAITING, out_bag) != 0) {
+						continue;
+					}
+					choice.clear();
+					for (uint64_t dom = packed.with(TW_DOMINATED, out_bag); dom != 0;
+							dom &= dom - 1) {
+						choice.push_back(__builtin_ctzll(dom) / 2);
+					}
+					auto best = DPTable::NONE;
+					TW_SIGNATURE_TYPE bestsig = 0;
+					for (size_t mask = ((size_t)1 << choice.size()); mask-- > 0;) {
+						TW_SIGNATURE_TYPE source = sig;
+						for (size_t k = 0; k < choice.size(); k++) {
+							if (mask >> k & 1) {
+								source -= TW_DOMINATED * POW3[choice[k]];
+							}
+						}
+						auto val = child.value(source);
+						if (val < best) {
+							best = val;
+							bestsig = source;
+						}
+					}
+					if (best != DPTable::NONE) {
+						table.fill(insertSigAt(sig, introducedindex, TW_INDS), best + 1, bestsig);
+						entries++;
+					}
 				}
-				return true;
+				std::lock_guard<std::mutex> lock(mutex);
+				table.addFilled(entries);
 			});
-			auto newsig = fromSigWithInsert(sigvec, introducedindex, TW_INDS);
-			updateTable(DP[curbag], newsig, std::get<0>(val) + 1, sig, 0);
 		}
-	}
+	} else {
+		child.forEach([&](TW_SIGNATURE_TYPE sig, size_t val, TW_SIGNATURE_TYPE) {
+			auto packed = PackedSig::fromSig(sig, childlen);
 
-	for (auto u : bag_nodes[bagchild]) {
-		currBagNodes.remove(u);
+			if (dominated) {
+				table.update(insertSigAt(sig, introducedindex, TW_DOMINATED), val, sig);
+			} else {
+				// need this for fast join nodes!
+				table.update(insertSigAt(sig, introducedindex, TW_WAITING), val, sig);
+				if (packed.anyInDs(in_bag)) {
+					table.update(insertSigAt(sig, introducedindex, TW_DOMINATED), val, sig);
+				}
+			}
+
+			if (!subsumed) {
+				packed.dominate(out_bag);
+				table.update(packed.toSigWithInsert(childlen, introducedindex, TW_INDS), val + 1,
+						sig);
+			}
+		});
 	}
+	table.compact();
 }
 
 std::unordered_map<std::pair<TW_SIGNATURE_TYPE, size_t>, u_int64_t, hash_pair> getDPCNTatBag(
-		std::unordered_map<TW_SIGNATURE_TYPE,
-				std::tuple<size_t, TW_SIGNATURE_TYPE, TW_SIGNATURE_TYPE>>& DPatbag) {
+		const DPTable& DPatbag) {
 	std::unordered_map<std::pair<TW_SIGNATURE_TYPE, size_t>, u_int64_t, hash_pair> DPCNTatBag;
-	for (auto& [sig, val] : DPatbag) {
-		DPCNTatBag[{sig, std::get<0>(val)}] = 1;
-	}
+	DPatbag.forEach([&](TW_SIGNATURE_TYPE sig, size_t val, TW_SIGNATURE_TYPE) {
+		DPCNTatBag[{sig, val}] = 1;
+	});
 	return DPCNTatBag;
 }
 
@@ -341,12 +517,142 @@ void transformDPCNTatBagBack(
 	}
 }
 
+// In-place transform of a (signature x kappa) count array for every digit: TW_QM ("dominated or
+// waiting") accumulates the TW_WAITING row (or, for back, the inverse). For each digit, the rows of
+// the two states form contiguous blocks, so the inner loop vectorizes.
+static void transformJoinArray(std::vector<uint32_t>& a, size_t sigsize, size_t width, bool back) {
+	for (size_t i = 0; i < sigsize; i++) {
+		size_t block = POW3[i] * width;
+		// the pairs of rows are split into ranges of whole blocks or parts of a single one
+		parallelRanges(a.size() / 3, DP_PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+			while (begin < end) {
+				size_t start = begin / block * 3 * block, j = begin % block;
+				size_t len = std::min(block - j, end - begin);
+				const uint32_t* __restrict waiting = a.data() + start + TW_WAITING * block + j;
+				uint32_t* __restrict qm = a.data() + start + TW_QM * block + j;
+				if (back) {
+					for (size_t k = 0; k < len; k++) {
+						qm[k] -= waiting[k];
+					}
+				} else {
+					for (size_t k = 0; k < len; k++) {
+						qm[k] += waiting[k];
+					}
+				}
+				begin += len;
+			}
+		});
+	}
+}
+
+bool ReductionTreeDecomposition::handleJoinNodeArray(htd::vertex_t curbag) {
+	auto bagchild1 = bags[curbag].children[0];
+	auto bagchild2 = bags[curbag].children[1];
+	size_t sigsize = bag_nodes[curbag].size();
+	if (sigsize > DPTable::DENSE_MAX_BAG) {
+		return false;
+	}
+	const DPTable& left = DP[bagchild1];
+	const DPTable& right = DP[bagchild2];
+	if (left.size() == 0 || right.size() == 0) {
+		initTable(curbag, sigsize, 0);
+		return true;
+	}
+
+	// kappa windows: all values of the left child, the band around minkappa for the right one
+	size_t min1 = std::numeric_limits<size_t>::max(), max1 = 0, max2 = 0;
+	left.forEach([&](TW_SIGNATURE_TYPE, size_t val, TW_SIGNATURE_TYPE) {
+		min1 = std::min(min1, val);
+		max1 = std::max(max1, val);
+	});
+	size_t min2 = minkappa[bagchild2];
+	right.forEach([&](TW_SIGNATURE_TYPE, size_t val, TW_SIGNATURE_TYPE) {
+		if (val <= min2 + treewidth + 1) {
+			max2 = std::max(max2, val);
+		}
+	});
+	size_t width1 = max1 - min1 + 1, width2 = max2 - min2 + 1, widthans = width1 + width2 - 1;
+	size_t slots = POW3[sigsize];
+	if (slots * (width1 + width2 + widthans) * sizeof(uint32_t) > JOIN_ARRAY_MAX_BYTES) {
+		return false;
+	}
+
+	// Counts are computed modulo 2^32, which is exact as no signature can be combined from more
+	// than 3^14 pairs of child signatures.
+	auto fill = [&](const DPTable& T, size_t base, size_t width, std::vector<uint32_t>& a) {
+		a.assign(slots * width, 0);
+		T.forEach([&](TW_SIGNATURE_TYPE sig, size_t val, TW_SIGNATURE_TYPE) {
+			if (val - base < width) {
+				a[sig * width + val - base] = 1;
+			}
+		});
+		transformJoinArray(a, sigsize, width, false);
+	};
+	std::vector<uint32_t> cntleft, cntright;
+	fill(left, min1, width1, cntleft);
+	fill(right, min2, width2, cntright);
+
+	// kappa offsets add up, the DS vertices of the bag are counted in both children
+	std::vector<uint32_t> cntans(slots * widthans, 0);
+	parallelRanges(slots, DP_PARALLEL_GRAIN / width1, [&](size_t begin, size_t end) {
+		for (size_t sig = begin; sig < end; sig++) {
+			const uint32_t* __restrict l = cntleft.data() + sig * width1;
+			const uint32_t* __restrict r = cntright.data() + sig * width2;
+			uint32_t* __restrict o = cntans.data() + sig * widthans;
+			for (size_t a = 0; a < width1; a++) {
+				if (l[a] == 0) {
+					continue;
+				}
+				uint32_t la = l[a];
+				for (size_t b = 0; b < width2; b++) {
+					o[a + b] += la * r[b];
+				}
+			}
+		}
+	});
+	cntleft = {};
+	cntright = {};
+	transformJoinArray(cntans, sigsize, widthans, true);
+
+	// the budget is exceeded, which stops the DP, but the join is done
+	if (!initTable(curbag, sigsize, slots)) {
+		return true;
+	}
+	DPTable& table = DP[curbag];
+	OGDF_ASSERT(table.isDense());
+	std::mutex mutex;
+	parallelRanges(slots, DP_PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+		size_t entries = 0, kappa = std::numeric_limits<size_t>::max();
+		for (size_t sig = begin; sig < end; sig++) {
+			const uint32_t* o = cntans.data() + sig * widthans;
+			for (size_t off = 0; off < widthans; off++) {
+				if (o[off] != 0) {
+					size_t cnt = min1 + min2 + off - cntInDs(sig);
+					kappa = std::min(kappa, cnt);
+					// the solution of children will be computed in the backtracking step
+					table.fill(sig, cnt, 0);
+					entries++;
+					break;
+				}
+			}
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		table.addFilled(entries);
+		minkappa[curbag] = std::min(minkappa[curbag], kappa);
+	});
+	table.compact();
+	return true;
+}
+
 void ReductionTreeDecomposition::handleJoinNode(htd::vertex_t curbag) {
 	// JOIN NODE
 	// log << "Join node " << curbag << std::endl;
-	OGDF_ASSERT(decomposition->children(curbag).size() == 2);
-	auto bagchild1 = decomposition->childAtPosition(curbag, 0);
-	auto bagchild2 = decomposition->childAtPosition(curbag, 1);
+	OGDF_ASSERT(bags[curbag].children.size() == 2);
+	if (handleJoinNodeArray(curbag)) {
+		return;
+	}
+	auto bagchild1 = bags[curbag].children[0];
+	auto bagchild2 = bags[curbag].children[1];
 	auto DPCNTleft = getDPCNTatBag(DP[bagchild1]);
 	auto DPCNTright = getDPCNTatBag(DP[bagchild2]);
 	transformDPCNTatBag(DPCNTleft, bag_nodes[bagchild1].size());
@@ -355,18 +661,20 @@ void ReductionTreeDecomposition::handleJoinNode(htd::vertex_t curbag) {
 	for (auto [sig_cnt, val] : DPCNTleft) {
 		auto sig = sig_cnt.first;
 		auto cnt = sig_cnt.second;
+		auto inds = cntInDs(sig);
 		for (int kappa = std::max((int)0, (int)minkappa[bagchild2] - (int)treewidth - 1);
 				kappa <= minkappa[bagchild2] + treewidth + 1; kappa++) {
 			// TODO: check if right range
-			if (DPCNTright.find({sig, kappa}) != DPCNTright.end()) {
-				if (DPCNTans.find({sig, cnt + kappa - cntInDs(sig)}) == DPCNTans.end()) {
-					DPCNTans[{sig, cnt + kappa - cntInDs(sig)}] = 0;
-				}
-				DPCNTans[{sig, cnt + kappa - cntInDs(sig)}] += val * DPCNTright[{sig, kappa}];
+			auto it = DPCNTright.find({sig, kappa});
+			if (it != DPCNTright.end()) {
+				DPCNTans[{sig, cnt + kappa - inds}] += val * it->second;
 			}
 		}
 	}
 	transformDPCNTatBagBack(DPCNTans, bag_nodes[bagchild1].size());
+	if (!initTable(curbag, bag_nodes[curbag].size(), DPCNTans.size())) {
+		return;
+	}
 	for (auto& [sig_cnt, val] : DPCNTans) {
 		if (val == 0) {
 			continue;
@@ -375,8 +683,9 @@ void ReductionTreeDecomposition::handleJoinNode(htd::vertex_t curbag) {
 		auto sig = sig_cnt.first;
 		auto cnt = sig_cnt.second;
 		// the solution of children will be computed in the backtracking step
-		updateTable(DP[curbag], sig, cnt, 0, 0);
+		DP[curbag].update(sig, cnt, 0);
 	}
+	DP[curbag].compact();
 	// log << "join node " << curbag << " done" << std::endl;
 	// for (auto& [sig, val] : DP[bagchild1]) {
 	// 	auto sigvec = toSigVec(sig, bag_nodes[bagchild1].size());
@@ -410,8 +719,8 @@ void ReductionTreeDecomposition::handleJoinNode(htd::vertex_t curbag) {
 }
 
 void ReductionTreeDecomposition::handleCopyNode(htd::vertex_t curbag) {
-	OGDF_ASSERT(decomposition->children(curbag).size() == 1);
-	auto bagchild = decomposition->childAtPosition(curbag, 0);
+	OGDF_ASSERT(bags[curbag].children.size() == 1);
+	auto bagchild = bags[curbag].children[0];
 	minkappa[curbag] = minkappa[bagchild];
 	OGDF_ASSERT(bag_nodes[curbag].size() == bag_nodes[bagchild].size());
 #ifdef OGDF_DEBUG
@@ -419,179 +728,355 @@ void ReductionTreeDecomposition::handleCopyNode(htd::vertex_t curbag) {
 		OGDF_ASSERT(bag_nodes[curbag][i] == bag_nodes[bagchild][i]);
 	}
 #endif
-	for (auto& [sig, val] : DP[bagchild]) {
-		auto sigvec = toSigVec(sig, bag_nodes[bagchild].size());
-		DP[curbag][sig] = {std::get<0>(val), sig, 0};
+	if (!initTable(curbag, bag_nodes[curbag].size(), DP[bagchild].size())) {
+		return;
 	}
+	DP[bagchild].forEach([&](TW_SIGNATURE_TYPE sig, size_t val, TW_SIGNATURE_TYPE) {
+		DP[curbag].update(sig, val, sig);
+	});
 }
 
 void ReductionTreeDecomposition::backTrackJoinNode(htd::vertex_t curbag) {
 	auto sig = chosensig[curbag];
-	auto val = std::get<0>(DP[curbag][sig]);
+	auto val = DP[curbag].value(sig);
 
-	auto child1 = decomposition->childAtPosition(curbag, 0);
-	auto child2 = decomposition->childAtPosition(curbag, 1);
+	auto child1 = bags[curbag].children[0];
+	auto child2 = bags[curbag].children[1];
 
 	// try to find two sigs for child1 and child2 that match sig
-	size_t cntdom = cntInDs(sig);
 	size_t l = bag_nodes[curbag].size();
+	auto cntdom = cntInDs(sig);
 
-	auto sigvec = toSigVec(sig, l);
-	std::vector<TW_SIGNATURE_TYPE> sigvecempty(l);
-	std::vector<size_t> inds;
+	// the DS vertices are the same in both children, all others are free in the left one
+	TW_SIGNATURE_TYPE base = 0;
+	std::vector<size_t> inds, indsr;
 	for (size_t i = 0; i < l; i++) {
-		if (sigvec[i] != TW_INDS) {
+		if (sigAt(sig, i) != TW_INDS) {
 			inds.push_back(i);
-		} else if (sigvec[i] == TW_WAITING) {
-			sigvecempty[i] = TW_WAITING;
 		} else {
-			sigvecempty[i] = TW_INDS;
-		}
-	}
-
-	auto cntbits = l - cntdom;
-	size_t to = pow((size_t)2, cntbits);
-	for (size_t bitmask = 0; bitmask < to; bitmask++) {
-		// log << "bitmask: " << bitmask << std::endl;
-		auto sigvecl = sigvecempty;
-		auto j = bitmask;
-		for (auto ind : inds) {
-			sigvecl[ind] = j & 1;
-			j >>= 1;
-		}
-		if (DP[child1].find(fromSigVec(sigvecl)) != DP[child1].end()) {
-			std::vector<size_t> indsr;
-			auto sigvecemptyr = sigvecempty;
-			for (size_t i = 0; i < l; i++) {
-				if (sigvec[i] == TW_DOMINATED && sigvecl[i] == TW_WAITING) {
-					sigvecemptyr[i] = TW_DOMINATED;
-				} else if (sigvec[i] == TW_DOMINATED) {
-					indsr.push_back(i);
-				}
+			base += TW_INDS * POW3[i];
+		}
+	}
+
+	for (size_t bitmask = 0; bitmask < ((size_t)1 << inds.size()); bitmask++) {
+		auto sigl = base;
+		for (size_t k = 0; k < inds.size(); k++) {
+			if (bitmask >> k & 1) {
+				sigl += TW_DOMINATED * POW3[inds[k]];
 			}
-			size_t tor = pow((size_t)2, indsr.size());
-			for (size_t bitmaskr = 0; bitmaskr < tor; bitmaskr++) {
-				// log << "bitmaskr: " << bitmaskr << std::endl;
-				auto sigvecr = sigvecemptyr;
-				auto j = bitmaskr;
-				for (auto ind : indsr) {
-					sigvecr[ind] = j & 1;
-					j >>= 1;
-				}
-				if (DP[child2].find(fromSigVec(sigvecr)) == DP[child2].end()) {
-					continue;
+		}
+		if (!DP[child1].contains(sigl)) {
+			continue;
+		}
+		// vertices that are dominated, but not from within the left child, need to be dominated
+		// from within the right one
+		auto baser = base;
+		indsr.clear();
+		for (auto i : inds) {
+			if (sigAt(sig, i) == TW_DOMINATED && sigAt(sigl, i) == TW_WAITING) {
+				baser += TW_DOMINATED * POW3[i];
+			} else if (sigAt(sig, i) == TW_DOMINATED) {
+				indsr.push_back(i);
+			}
+		}
+		for (size_t bitmaskr = 0; bitmaskr < ((size_t)1 << indsr.size()); bitmaskr++) {
+			auto sigr = baser;
+			for (size_t k = 0; k < indsr.size(); k++) {
+				if (bitmaskr >> k & 1) {
+					sigr += TW_DOMINATED * POW3[indsr[k]];
 				}
-				auto sigl = fromSigVec(sigvecl);
-				auto sigr = fromSigVec(sigvecr);
-				auto val1 = std::get<0>(DP[child1][sigl]);
-				auto val2 = std::get<0>(DP[child2][sigr]);
-				if (val == val1 + val2 - cntInDs(sig)) {
-					if (chosensig.size() <= std::max(child1, child2)) {
-						chosensig.resize(std::max(child1, child2) + 1);
-					}
-					chosensig[child1] = sigl;
-					chosensig[child2] = sigr;
-					return;
+			}
+			if (!DP[child2].contains(sigr)) {
+				continue;
+			}
+			auto val1 = DP[child1].value(sigl);
+			auto val2 = DP[child2].value(sigr);
+			if (val == val1 + val2 - cntdom) {
+				if (chosensig.size() <= std::max(child1, child2)) {
+					chosensig.resize(std::max(child1, child2) + 1);
 				}
+				chosensig[child1] = sigl;
+				chosensig[child2] = sigr;
+				return;
 			}
 		}
 	}
 	OGDF_ASSERT(false);
 }
 
-int ReductionTreeDecomposition::solveDPExact() {
-	// Algorithm from https://arxiv.org/pdf/1806.01667
-	OGDF_ASSERT(decomposition != nullptr);
-	htd::PostOrderTreeTraversal traversal;
-
-	traversal.traverse(*decomposition,
-			[&](htd::vertex_t curbag, htd::vertex_t bagparent, std::size_t depth) {
-				OGDF_ASSERT(decomposition->isVertex(curbag));
-				if (DP.size() <= curbag) {
-					DP.resize(curbag + 1);
-					// DPCNT.resize(curbag + 1);
-					bag_nodes.resize(curbag + 1);
-					minkappa.resize(curbag + 1);
-				}
-				minkappa[curbag] = std::numeric_limits<size_t>::max();
-				for (auto u : decomposition->bagContent(curbag)) {
-					ogdf::node node = idnode[u];
-					bag_nodes[curbag].push_back(node);
-				}
-				std::sort(bag_nodes[curbag].begin(), bag_nodes[curbag].end());
+bool ReductionTreeDecomposition::fitsDPMemory() {
+	OGDF_ASSERT(hasDecomposition());
+	dpMemoryEstimate = 0;
+	dpMemoryPeakBag = 0;
+	for (size_t bag = 0; bag < bags.size(); bag++) {
+		size_t k = bag_nodes[bag].size();
+		dpMemoryEstimate += worstTableBytes(k, true);
+		// the children are frozen only after the bag is computed
+		size_t peak = worstTableBytes(k, false);
+		for (auto child : bags[bag].children) {
+			peak += worstTableBytes(bag_nodes[child].size(), false);
+		}
+		if (bags[bag].type == BagType::JOIN) {
+			peak += JOIN_ARRAY_MAX_BYTES;
+		}
+		dpMemoryPeakBag = std::max(dpMemoryPeakBag, peak);
+	}
+	dpMemoryEstimate += dpMemoryPeakBag;
+	log << "DP needs at most " << (dpMemoryEstimate >> 20) << " MiB, " << (dpMemoryPeakBag >> 20)
+		<< " MiB for the largest bag, budget is " << (dpMemoryBudget() >> 20) << " MiB"
+		<< std::endl;
+	return dpMemoryPeakBag <= dpMemoryBudget();
+}
 
-				if (decomposition->isLeaf(curbag)) {
-					handleLeaf(curbag);
+void ReductionTreeDecomposition::freezeChildren(htd::vertex_t curbag) {
+	// introduce, forget and copy nodes only need their backpointers, joins look up the values of
+	// their own and their children's tables
+	bool join = bags[curbag].type == BagType::JOIN;
+	for (auto child : bags[curbag].children) {
+		bool childjoin = bags[child].type == BagType::JOIN;
+		DP[child].freeze(join || childjoin, !childjoin && bags[child].type != BagType::LEAF);
+	}
+}
 
-				} else if (decomposition->isForgetNode(curbag)) {
-					handleForgetNode(curbag);
-				} else if (decomposition->isIntroduceNode(curbag)) {
-					handleIntroduceNode(curbag);
+bool ReductionTreeDecomposition::initTable(htd::vertex_t curbag, size_t size, size_t expected) {
+	{
+		std::lock_guard<std::mutex> lock(dp_memory_mutex);
+		size_t bytes = DPTable::initBytes(size, expected);
+		if (bytes > dp_bytes[curbag]) {
+			if (!reserveDPMemory(bytes - dp_bytes[curbag])) {
+				dp_over_budget = true;
+				return false;
+			}
+			dp_bytes_total += bytes - dp_bytes[curbag];
+			dp_memory_reserved += bytes - dp_bytes[curbag];
+			dp_bytes[curbag] = bytes;
+		}
+	}
+	DP[curbag].init(size, expected);
+	return true;
+}
 
-				} else if (decomposition->isJoinNode(curbag)) {
-					handleJoinNode(curbag);
-				} else {
-					// There seem to be nodes with children having the exact same bag
-					handleCopyNode(curbag);
+bool ReductionTreeDecomposition::accountDPMemory(htd::vertex_t curbag) {
+	std::lock_guard<std::mutex> lock(dp_memory_mutex);
+	auto set = [&](htd::vertex_t bag) {
+		dp_bytes_total -= dp_bytes[bag];
+		dp_bytes[bag] = DP[bag].memoryUsage();
+		dp_bytes_total += dp_bytes[bag];
+	};
+	set(curbag);
+	for (auto child : bags[curbag].children) {
+		set(child);
+	}
+	if (dp_bytes_total > dp_memory_reserved) {
+		if (!reserveDPMemory(dp_bytes_total - dp_memory_reserved)) {
+			return false;
+		}
+	} else {
+		dp_memory_in_use -= dp_memory_reserved - dp_bytes_total;
+	}
+	dp_memory_reserved = dp_bytes_total;
+	return true;
+}
+
+void ReductionTreeDecomposition::releaseDPMemory() {
+	DP = {};
+	dp_bytes = {};
+	dp_bytes_total = 0;
+	dp_memory_in_use -= dp_memory_reserved;
+	dp_memory_reserved = 0;
+}
+
+void ReductionTreeDecomposition::collectBags() {
+	size_t size = 0;
+	for (htd::vertex_t bag : decomposition->vertices()) {
+		size = std::max<size_t>(size, bag + 1);
+	}
+	bags.assign(size, Bag());
+	bag_nodes.assign(size, {});
+	root_bag = decomposition->root();
+	for (htd::vertex_t bag : decomposition->vertices()) {
+		Bag& b = bags[bag];
+		for (auto u : decomposition->bagContent(bag)) {
+			bag_nodes[bag].push_back(idnode[u]);
+		}
+		std::sort(bag_nodes[bag].begin(), bag_nodes[bag].end());
+		b.parent = bag == decomposition->root() ? htd::Vertex::UNKNOWN
+												: decomposition->parent(bag);
+		for (size_t i = 0; i < decomposition->childCount(bag); i++) {
+			b.children.push_back(decomposition->childAtPosition(bag, i));
+		}
+		if (decomposition->isLeaf(bag)) {
+			b.type = BagType::LEAF;
+			b.vertex = idnode[decomposition->bagContent(bag)[0]];
+		} else if (decomposition->isForgetNode(bag)) {
+			OGDF_ASSERT(decomposition->forgottenVertices(bag).size() == 1);
+			b.type = BagType::FORGET;
+			b.vertex = idnode[*decomposition->forgottenVertices(bag).begin()];
+		} else if (decomposition->isIntroduceNode(bag)) {
+			OGDF_ASSERT(decomposition->introducedVertices(bag).size() == 1);
+			b.type = BagType::INTRODUCE;
+			b.vertex = idnode[*decomposition->introducedVertices(bag).begin()];
+		} else if (decomposition->isJoinNode(bag)) {
+			b.type = BagType::JOIN;
+		} else {
+			// There seem to be nodes with children having the exact same bag
+			b.type = BagType::COPY;
+		}
+	}
+}
+
+void ReductionTreeDecomposition::collectBags(const EliminationDecomposition& native) {
+	// shifted by one, so that the parent of the root is htd::Vertex::UNKNOWN
+	bags.assign(native.bags.size() + 1, Bag());
+	bag_nodes.assign(bags.size(), {});
+	root_bag = native.root + 1;
+	for (size_t nb = 0; nb < native.bags.size(); nb++) {
+		const auto& from = native.bags[nb];
+		Bag& b = bags[nb + 1];
+		for (auto it = native.bagBegin(nb); it != native.bagEnd(nb); ++it) {
+			bag_nodes[nb + 1].push_back(idnode[*it + 1]);
+		}
+		std::sort(bag_nodes[nb + 1].begin(), bag_nodes[nb + 1].end());
+		b.parent = from.parent + 1;
+		for (int child : from.children) {
+			if (child != EliminationDecomposition::NONE) {
+				b.children.push_back(child + 1);
+			}
+		}
+		if (from.vertex != EliminationDecomposition::NONE) {
+			b.vertex = idnode[from.vertex + 1];
+		}
+		switch (from.type) {
+		case EliminationDecomposition::Type::LEAF:
+			b.type = BagType::LEAF;
+			break;
+		case EliminationDecomposition::Type::INTRODUCE:
+			b.type = BagType::INTRODUCE;
+			break;
+		case EliminationDecomposition::Type::FORGET:
+			b.type = BagType::FORGET;
+			break;
+		case EliminationDecomposition::Type::JOIN:
+			b.type = BagType::JOIN;
+			break;
+		}
+	}
+}
+
+bool ReductionTreeDecomposition::computeBag(htd::vertex_t curbag) {
+	switch (bags[curbag].type) {
+	case BagType::LEAF:
+		handleLeaf(curbag);
+		break;
+	case BagType::FORGET:
+		handleForgetNode(curbag);
+		break;
+	case BagType::INTRODUCE:
+		handleIntroduceNode(curbag);
+		break;
+	case BagType::JOIN:
+		handleJoinNode(curbag);
+		break;
+	case BagType::COPY:
+		handleCopyNode(curbag);
+		break;
+	}
+	if (dp_over_budget) {
+		return false;
+	}
+	freezeChildren(curbag);
+	return accountDPMemory(curbag);
+}
+
+int ReductionTreeDecomposition::solveDPExact() {
+	// Algorithm from https://arxiv.org/pdf/1806.01667
+	OGDF_ASSERT(hasDecomposition());
+	auto root = root_bag;
+	minkappa.assign(bags.size(), std::numeric_limits<size_t>::max());
+	DP.resize(bags.size());
+	dp_bytes.assign(bags.size(), 0);
+	dp_over_budget = false;
+
+	// Every leaf starts a task that continues with the parent once it finished its last child, so
+	// independent subtrees are computed concurrently. A table only depends on the tables of the
+	// children, thus the result is the same for any schedule.
+	std::vector<std::atomic<size_t>> pending(bags.size());
+	for (size_t bag = 0; bag < bags.size(); bag++) {
+		pending[bag] = bags[bag].children.size();
+	}
+	std::atomic<bool> outofmemory {false};
+	TaskGroup group;
+	for (htd::vertex_t bag = 0; bag < bags.size(); bag++) {
+		if (bags[bag].type != BagType::LEAF) {
+			continue;
+		}
+		group.run([&, bag] {
+			for (htd::vertex_t curbag = bag;;) {
+				if (outofmemory || !computeBag(curbag)) {
+					outofmemory = true;
+					return;
 				}
-			});
+				if (curbag == root || --pending[bags[curbag].parent] > 0) {
+					return;
+				}
+				curbag = bags[curbag].parent;
+			}
+		});
+	}
+	group.wait();
+	if (outofmemory) {
+		log << "DP tables exceed the memory budget of " << (dpMemoryBudget() >> 20) << " MiB"
+			<< std::endl;
+		releaseDPMemory();
+		return -1;
+	}
 	int ans = std::numeric_limits<int>::max();
 	TW_SIGNATURE_TYPE anssig;
-	for (auto& [sig, val] : DP[decomposition->root()]) {
-		if (cntUndominated(sig, decomposition->bagContent(decomposition->root()).size()) == 0) {
-			if ((int)std::get<0>(val) < ans) {
+	DP[root].forEach([&](TW_SIGNATURE_TYPE sig, size_t val, TW_SIGNATURE_TYPE) {
+		if (cntUndominated(sig, bag_nodes[root].size()) == 0) {
+			if ((int)val < ans) {
 				anssig = sig;
-				ans = (int)std::get<0>(val);
+				ans = (int)val;
 			}
 		}
-	}
+	});
 	// return ans;
 
 	log << "Solved, now backtracking" << std::endl;
 
-	chosensig.resize(decomposition->root() + 1);
-	chosensig[decomposition->root()] = anssig;
-	htd::PreOrderTreeTraversal traversalpre;
+	chosensig.resize(bags.size());
+	chosensig[root] = anssig;
 	int sizebefore = I.DS.size();
 	std::set<ogdf::node> addednodes;
-	traversalpre.traverse(*decomposition,
-			[&](htd::vertex_t curbag, htd::vertex_t bagparent, std::size_t depth) {
-				OGDF_ASSERT(decomposition->isVertex(curbag));
-				if (decomposition->isLeaf(curbag) || decomposition->isIntroduceNode(curbag)) {
-					htd::vertex_t introduced;
-					if (decomposition->isLeaf(curbag)) {
-						introduced = decomposition->bagContent(curbag)[0];
-					} else {
-						introduced = *decomposition->introducedVertices(curbag).begin();
-					}
-					ogdf::node introducedvertex = idnode[introduced];
-					size_t introducedindex = lower_bound(bag_nodes[curbag].begin(),
-													 bag_nodes[curbag].end(), introducedvertex)
-							- bag_nodes[curbag].begin();
-					auto status = sigAt(chosensig[curbag], introducedindex);
-					if (status == TW_INDS && addednodes.find(introducedvertex) == addednodes.end()) {
-						addednodes.insert(introducedvertex);
-						I.DS.insert(I.node2ID(introducedvertex));
-					}
-					for (auto u : decomposition->children(curbag)) {
-						if (chosensig.size() <= u) {
-							chosensig.resize(u + 1);
-						}
-						auto t = DP[curbag][chosensig[curbag]];
-						chosensig[u] = std::get<1>(t);
-					}
-				} else if (decomposition->isJoinNode(curbag)) {
-					backTrackJoinNode(curbag);
-				} else {
-					for (auto u : decomposition->children(curbag)) {
-						if (chosensig.size() <= u) {
-							chosensig.resize(u + 1);
-						}
-						auto t = DP[curbag][chosensig[curbag]];
-						chosensig[u] = std::get<1>(t);
-					}
-				}
-			});
+	// pre-order, the signature of a bag is chosen before its children are visited
+	std::vector<htd::vertex_t> stack {root};
+	while (!stack.empty()) {
+		auto curbag = stack.back();
+		stack.pop_back();
+		auto type = bags[curbag].type;
+		if (type == BagType::LEAF || type == BagType::INTRODUCE) {
+			ogdf::node introducedvertex = bags[curbag].vertex;
+			size_t introducedindex = lower_bound(bag_nodes[curbag].begin(),
+											 bag_nodes[curbag].end(), introducedvertex)
+					- bag_nodes[curbag].begin();
+			auto status = sigAt(chosensig[curbag], introducedindex);
+			if (status == TW_INDS && addednodes.find(introducedvertex) == addednodes.end()) {
+				addednodes.insert(introducedvertex);
+				I.DS.insert(I.node2ID(introducedvertex));
+			}
+			for (auto u : bags[curbag].children) {
+				chosensig[u] = DP[curbag].back(chosensig[curbag]);
+			}
+		} else if (type == BagType::JOIN) {
+			backTrackJoinNode(curbag);
+		} else {
+			for (auto u : bags[curbag].children) {
+				chosensig[u] = DP[curbag].back(chosensig[curbag]);
+			}
+		}
+		stack.insert(stack.end(), bags[curbag].children.begin(), bags[curbag].children.end());
+	}
+	releaseDPMemory();
 
 	int cntadded = I.DS.size() - sizebefore;
 	OGDF_ASSERT(cntadded == ans);
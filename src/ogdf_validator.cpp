@@ -1,7 +1,7 @@
 #include "ogdf_instance.hpp"
 #include "ogdf_util.hpp"
 
-ogdf::Logger logger;
+thread_local ogdf::Logger logger;
 
 int main(int argc, char** argv) {
 	logger.localLogLevel(ogdf::Logger::Level::Default);
@@ -12,12 +12,12 @@ int main(int argc, char** argv) {
 	}
 	std::vector<ogdf::node> ID2node;
 	{
-		std::ifstream fin(argv[1]);
-		if (!fin.good()) {
+		InputBuffer input;
+		if (!input.openFile(argv[1])) {
 			std::cerr << "Error opening file " << argv[1] << std::endl;
 			return 1;
 		}
-		I.read(fin, ID2node);
+		I.read(input, ID2node);
 	}
 	std::cout << "Instance with " << I.G.numberOfNodes() << " vertices and " << I.G.numberOfEdges()
 			  << " edges" << std::endl;
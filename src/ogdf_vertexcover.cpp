@@ -0,0 +1,53 @@
+#include <mutex>
+
+#include "ogdf_vertexcover.hpp"
+
+// the bundled solver is a single C file with global state, it is only used from here
+#include "MomC.cc"
+
+static std::mutex momc_mutex;
+
+bool solveVertexCover(
+		const ConflictGraph& G, const VertexCoverLimits& limits, std::vector<int>& cover) {
+	int n = G.numberOfNodes();
+	cover.clear();
+	if (n > VC_MAX_VERTICES) {
+		return false;
+	}
+	if (G.numberOfEdges() == 0) {
+		return true;
+	}
+	// MoMC numbers the vertices from 1
+	std::vector<int> left, right;
+	left.reserve(G.numberOfEdges());
+	right.reserve(G.numberOfEdges());
+	for (int u = 0; u < n; u++) {
+		for (uint64_t i = G.begin[u]; i < G.begin[u + 1]; i++) {
+			if ((int)G.adj[i] > u) {
+				left.push_back(u + 1);
+				right.push_back(G.adj[i] + 1);
+			}
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(momc_mutex);
+	build_graph_from_edges(n, left.data(), right.data(), left.size(), TRUE);
+	search_initial_maximum_clique();
+	init_for_maxclique(-1, FALSE);
+	re_code();
+	if (!search_maxclique(0, FALSE, limits.branches, true, limits.seconds)) {
+		return false;
+	}
+
+	// the vertices outside of the maximum independent set, which is in the recoded numbering
+	std::vector<char> independent(n, 0);
+	for (int i = 0; i < MAX_CLQ_SIZE; i++) {
+		independent[NEW_OLD[MaxCLQ_Stack[i]] - 1] = 1;
+	}
+	for (int v = 0; v < n; v++) {
+		if (!independent[v]) {
+			cover.push_back(v);
+		}
+	}
+	return true;
+}